@@ -9,4 +9,5 @@
 
 /* #include "lcf_math.c" */
 #include "lcf_memory.c"
+#include "lcf_heap.c"
 #include "lcf_string.c"
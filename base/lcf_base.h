@@ -3,6 +3,7 @@
 
 #include "lcf_types.h"
 #include "lcf_memory.h"
+#include "lcf_heap.h"
 #include "lcf_string.h"
 #include "lcf_hash.h"
 #include "lcf_random.h"
@@ -0,0 +1,648 @@
+#include "lcf_heap.h"
+
+#define HEAP_BLOCK_FREE 1
+#define HEAP_BLOCK_PREV_FREE 2
+#define HEAP_BLOCK_FLAGS (HEAP_BLOCK_FREE | HEAP_BLOCK_PREV_FREE)
+#define HEAP_ALIGN ((u64) 1 << HEAP_ALIGN_LOG2)
+#define HEAP_BLOCK_OVERHEAD sizeof(u64) /* the size field */
+#define HEAP_BLOCK_START (sizeof(HeapBlock*) + sizeof(u64)) /* user memory starts after size */
+#define HEAP_BLOCK_MIN (sizeof(HeapBlock) - sizeof(HeapBlock*))
+#define HEAP_BLOCK_MAX ((u64) 1 << HEAP_FL_MAX)
+#define HEAP_SMALL_BLOCK ((u64) 1 << HEAP_FL_SHIFT)
+
+/* Blocks */
+internal u64 _HeapBlock_size(HeapBlock *b) {
+    return b->size & ~(u64) HEAP_BLOCK_FLAGS;
+}
+
+internal void _HeapBlock_set_size(HeapBlock *b, u64 size) {
+    b->size = size | (b->size & HEAP_BLOCK_FLAGS);
+}
+
+internal u8* _HeapBlock_ptr(HeapBlock *b) {
+    return (u8*) b + HEAP_BLOCK_START;
+}
+
+internal HeapBlock* _HeapBlock_from_ptr(void *ptr) {
+    return (HeapBlock*) ((u8*) ptr - HEAP_BLOCK_START);
+}
+
+internal HeapBlock* _HeapBlock_next(HeapBlock *b) {
+    return (HeapBlock*) (_HeapBlock_ptr(b) + _HeapBlock_size(b) - HEAP_BLOCK_OVERHEAD);
+}
+
+internal HeapBlock* _HeapBlock_link_next(HeapBlock *b) {
+    HeapBlock *next = _HeapBlock_next(b);
+    next->prev_phys = b;
+    return next;
+}
+
+internal void _HeapBlock_mark_free(HeapBlock *b) {
+    HeapBlock *next = _HeapBlock_link_next(b);
+    next->size |= HEAP_BLOCK_PREV_FREE;
+    b->size |= HEAP_BLOCK_FREE;
+}
+
+internal void _HeapBlock_mark_used(HeapBlock *b) {
+    HeapBlock *next = _HeapBlock_next(b);
+    next->size &= ~(u64) HEAP_BLOCK_PREV_FREE;
+    b->size &= ~(u64) HEAP_BLOCK_FREE;
+}
+
+internal s32 _HeapBlock_can_split(HeapBlock *b, u64 size) {
+    return _HeapBlock_size(b) >= sizeof(HeapBlock) + size;
+}
+
+/* Splits b so it has size bytes, returns the free remainder */
+internal HeapBlock* _HeapBlock_split(HeapBlock *b, u64 size) {
+    HeapBlock *rest = (HeapBlock*) (_HeapBlock_ptr(b) + size - HEAP_BLOCK_OVERHEAD);
+    rest->size = _HeapBlock_size(b) - (size + HEAP_BLOCK_OVERHEAD);
+    _HeapBlock_mark_free(rest);
+    _HeapBlock_set_size(b, size);
+    return rest;
+}
+
+/* b must be the physical next block of prev */
+internal HeapBlock* _HeapBlock_absorb(HeapBlock *prev, HeapBlock *b) {
+    prev->size += _HeapBlock_size(b) + HEAP_BLOCK_OVERHEAD;
+    _HeapBlock_link_next(prev);
+    return prev;
+}
+
+/* Size classes */
+internal void _Heap_mapping(u64 size, u32 *fl, u32 *sl) {
+    if (size < HEAP_SMALL_BLOCK) {
+        *fl = 0;
+        *sl = (u32) (size / (HEAP_SMALL_BLOCK / HEAP_SL_COUNT));
+    } else {
+        u32 f = bit_scan_reverse_u64(size);
+        *sl = (u32) (size >> (f - HEAP_SL_LOG2)) ^ HEAP_SL_COUNT;
+        *fl = f - (HEAP_FL_SHIFT - 1);
+    }
+}
+
+/* Rounds size up to the next class, so any block found in that class is big enough */
+internal u64 _Heap_round_search(u64 size) {
+    if (size >= HEAP_SMALL_BLOCK) {
+        size += ((u64) 1 << (bit_scan_reverse_u64(size) - HEAP_SL_LOG2)) - 1;
+    }
+    return size;
+}
+
+internal u64 _Heap_adjust_size(u64 size, u64 alignment) {
+    u64 result = 0;
+    if (size) {
+        u64 aligned = next_alignment(0, size, alignment);
+        if (aligned < HEAP_BLOCK_MAX) {
+            result = MAX(aligned, HEAP_BLOCK_MIN);
+        }
+    }
+    return result;
+}
+
+/* Free lists */
+internal void _Heap_insert(Heap *h, HeapBlock *b) {
+    u32 fl, sl;
+    _Heap_mapping(_HeapBlock_size(b), &fl, &sl);
+    HeapBlock *first = h->free[fl][sl];
+    b->next_free = first;
+    b->prev_free = 0;
+    if (first) {
+        first->prev_free = b;
+    }
+    h->free[fl][sl] = b;
+    h->fl_bitmap |= (u64) 1 << fl;
+    h->sl_bitmap[fl] |= (u32) 1 << sl;
+}
+
+internal void _Heap_remove(Heap *h, HeapBlock *b, u32 fl, u32 sl) {
+    HeapBlock *prev = b->prev_free;
+    HeapBlock *next = b->next_free;
+    if (next) {
+        next->prev_free = prev;
+    }
+    if (prev) {
+        prev->next_free = next;
+    } else {
+        h->free[fl][sl] = next;
+        if (!next) {
+            h->sl_bitmap[fl] &= ~((u32) 1 << sl);
+            if (!h->sl_bitmap[fl]) {
+                h->fl_bitmap &= ~((u64) 1 << fl);
+            }
+        }
+    }
+}
+
+internal void _Heap_remove_block(Heap *h, HeapBlock *b) {
+    u32 fl, sl;
+    _Heap_mapping(_HeapBlock_size(b), &fl, &sl);
+    _Heap_remove(h, b, fl, sl);
+}
+
+internal HeapBlock* _Heap_merge_prev(Heap *h, HeapBlock *b) {
+    if (b->size & HEAP_BLOCK_PREV_FREE) {
+        HeapBlock *prev = b->prev_phys;
+        _Heap_remove_block(h, prev);
+        b = _HeapBlock_absorb(prev, b);
+    }
+    return b;
+}
+
+internal HeapBlock* _Heap_merge_next(Heap *h, HeapBlock *b) {
+    HeapBlock *next = _HeapBlock_next(b);
+    if (next->size & HEAP_BLOCK_FREE) {
+        _Heap_remove_block(h, next);
+        b = _HeapBlock_absorb(b, next);
+    }
+    return b;
+}
+
+/* Gives back the end of a free block that is bigger than needed */
+internal void _Heap_trim_free(Heap *h, HeapBlock *b, u64 size) {
+    if (_HeapBlock_can_split(b, size)) {
+        HeapBlock *rest = _HeapBlock_split(b, size);
+        _HeapBlock_link_next(b);
+        rest->size |= HEAP_BLOCK_PREV_FREE;
+        _Heap_insert(h, rest);
+    }
+}
+
+/* Gives back the end of a used block, merging it with the next block if that is free */
+internal void _Heap_trim_used(Heap *h, HeapBlock *b, u64 size) {
+    if (_HeapBlock_can_split(b, size)) {
+        HeapBlock *rest = _HeapBlock_split(b, size);
+        rest->size &= ~(u64) HEAP_BLOCK_PREV_FREE;
+        rest = _Heap_merge_next(h, rest);
+        _Heap_insert(h, rest);
+    }
+}
+
+/* Gives back the start of a free block, used to align allocations */
+internal HeapBlock* _Heap_trim_free_leading(Heap *h, HeapBlock *b, u64 size) {
+    HeapBlock *rest = b;
+    if (_HeapBlock_can_split(b, size)) {
+        rest = _HeapBlock_split(b, size - HEAP_BLOCK_OVERHEAD);
+        rest->size |= HEAP_BLOCK_PREV_FREE;
+        _HeapBlock_link_next(b);
+        _Heap_insert(h, b);
+    }
+    return rest;
+}
+
+internal HeapBlock* _Heap_locate_free(Heap *h, u64 size) {
+    HeapBlock *b = 0;
+    if (size) {
+        u32 fl, sl;
+        _Heap_mapping(_Heap_round_search(size), &fl, &sl);
+        if (fl < HEAP_FL_COUNT) {
+            /* First non empty list in this class or above, then in the next classes up */
+            u32 sl_map = h->sl_bitmap[fl] & (~(u32) 0 << sl);
+            if (!sl_map) {
+                u64 fl_map = h->fl_bitmap & (~(u64) 0 << (fl + 1));
+                if (fl_map) {
+                    fl = bit_scan_forward_u64(fl_map);
+                    sl_map = h->sl_bitmap[fl];
+                }
+            }
+            if (sl_map) {
+                sl = bit_scan_forward_u64(sl_map);
+                b = h->free[fl][sl];
+                _Heap_remove(h, b, fl, sl);
+            }
+        }
+    }
+    return b;
+}
+
+/* Commits more memory at the end, the old sentinel becomes a free block covering it */
+internal s32 _Heap_grow(Heap *h, u64 size) {
+    u64 needed = _Heap_round_search(size) + HEAP_BLOCK_OVERHEAD;
+    u64 step = (u64) h->commit_size << MIN(h->commits, 32);
+    step = MIN(step, MAX(LCF_MEMORY_COMMIT_GROW_MAX, h->commit_size));
+    u64 new_commit_pos = MIN(next_alignment(0, h->commit_pos + MAX(step, needed), h->commit_size), h->size);
+    u64 delta = new_commit_pos - h->commit_pos;
+    if (delta < needed || !LCF_MEMORY_commit((u8*) h + h->commit_pos, delta)) {
+        return 0;
+    }
+    h->commit_pos = new_commit_pos;
+    h->commits++;
+
+    HeapBlock *b = h->last;
+    _HeapBlock_set_size(b, delta - HEAP_BLOCK_OVERHEAD);
+    h->last = _HeapBlock_next(b);
+    h->last->size = 0;
+    _HeapBlock_mark_free(b);
+    b = _Heap_merge_prev(h, b);
+    _Heap_insert(h, b);
+    return 1;
+}
+
+/* Heap */
+Heap* Heap_create_custom(u64 size, u32 commit_size, u32 alignment) {
+    ASSERT(is_power_of_2(commit_size));
+    ASSERTM(is_power_of_2(alignment), "Alignments must be a power of 2.");
+
+    size = next_alignment(0, size, commit_size);
+    Heap *h = (Heap*) LCF_MEMORY_reserve(size);
+    u64 commit_pos = next_alignment(0, sizeof(Heap) + sizeof(HeapBlock), commit_size);
+    LCF_MEMORY_commit(h, commit_pos);
+    memset(h, 0, sizeof(Heap));
+    h->size = size;
+    h->commit_pos = commit_pos;
+    h->commit_size = commit_size;
+    h->alignment = alignment;
+
+    /* The sentinel ends exactly at commit_pos, so growing extends it in place */
+    h->first = (HeapBlock*) ((u8*) h + commit_pos - HEAP_BLOCK_START);
+    h->last = h->first;
+    h->last->size = 0;
+    return h;
+}
+
+void Heap_destroy(Heap *h) {
+    LCF_MEMORY_free(h, h->size);
+}
+
+void* Heap_alloc_custom(Heap *h, u64 size, u32 alignment) {
+    ASSERTM(is_power_of_2(alignment), "Alignments must be a power of 2.");
+
+    /* Over allocate for alignment so there is room to split off a free block in front */
+    u64 adjust = _Heap_adjust_size(size, HEAP_ALIGN);
+    u64 gap_min = sizeof(HeapBlock);
+    u64 search_size = adjust;
+    if (adjust && alignment > HEAP_ALIGN) {
+        search_size = _Heap_adjust_size(adjust + alignment + gap_min, alignment);
+    }
+
+    HeapBlock *b = _Heap_locate_free(h, search_size);
+    if (!b && search_size && _Heap_grow(h, search_size)) {
+        b = _Heap_locate_free(h, search_size);
+    }
+
+    void *result = 0;
+    if (b) {
+        if (alignment > HEAP_ALIGN) {
+            u8 *ptr = _HeapBlock_ptr(b);
+            u64 gap = next_alignment(ptr, 0, alignment);
+            if (gap && gap < gap_min) {
+                gap = next_alignment(ptr, gap + MAX(gap_min - gap, alignment), alignment);
+            }
+            if (gap) {
+                b = _Heap_trim_free_leading(h, b, gap);
+            }
+        }
+        _Heap_trim_free(h, b, adjust);
+        _HeapBlock_mark_used(b);
+        result = _HeapBlock_ptr(b);
+    }
+
+    ASSERT(result || !size); // Heap out of memory!
+    return result;
+}
+
+void* Heap_alloc(Heap *h, u64 size) {
+    return Heap_alloc_custom(h, size, h->alignment);
+}
+
+void* Heap_alloc_zero(Heap *h, u64 size) {
+    void *mem = Heap_alloc_custom(h, size, h->alignment);
+    memset(mem, 0, size);
+    return mem;
+}
+
+void Heap_free(Heap *h, void *ptr) {
+    if (ptr) {
+        HeapBlock *b = _HeapBlock_from_ptr(ptr);
+        ASSERTM(!(b->size & HEAP_BLOCK_FREE), "Heap block freed twice.");
+        if (LCF_MEMORY_DEBUG_CLEAR) {
+            memset(ptr, LCF_MEMORY_ARENA_CLEAR, _HeapBlock_size(b));
+        }
+        _HeapBlock_mark_free(b);
+        b = _Heap_merge_prev(h, b);
+        b = _Heap_merge_next(h, b);
+        _Heap_insert(h, b);
+    }
+}
+
+void* Heap_realloc(Heap *h, void *ptr, u64 size) {
+    if (!ptr) {
+        return Heap_alloc(h, size);
+    }
+    if (!size) {
+        Heap_free(h, ptr);
+        return 0;
+    }
+
+    HeapBlock *b = _HeapBlock_from_ptr(ptr);
+    HeapBlock *next = _HeapBlock_next(b);
+    u64 size_now = _HeapBlock_size(b);
+    u64 combined = size_now + _HeapBlock_size(next) + HEAP_BLOCK_OVERHEAD;
+    u64 adjust = _Heap_adjust_size(size, HEAP_ALIGN);
+    ASSERTM(!(b->size & HEAP_BLOCK_FREE), "Heap block already freed.");
+
+    /* Grow into the next block when it is free and big enough, otherwise move */
+    if (adjust > size_now && (!(next->size & HEAP_BLOCK_FREE) || adjust > combined)) {
+        void *result = Heap_alloc(h, size);
+        if (result) {
+            memcpy(result, ptr, MIN(size_now, size));
+            Heap_free(h, ptr);
+        }
+        return result;
+    }
+
+    if (adjust > size_now) {
+        _Heap_merge_next(h, b);
+        _HeapBlock_mark_used(b);
+    }
+    _Heap_trim_used(h, b, adjust);
+    return ptr;
+}
+
+u64 Heap_block_size(void *ptr) {
+    return _HeapBlock_size(_HeapBlock_from_ptr(ptr));
+}
+
+HeapStats Heap_stats(Heap *h) {
+    HeapStats s = ZERO_STRUCT;
+    s.committed = h->commit_pos;
+    s.commits = h->commits;
+    for (HeapBlock *b = h->first; b != h->last; b = _HeapBlock_next(b)) {
+        u64 size = _HeapBlock_size(b);
+        if (b->size & HEAP_BLOCK_FREE) {
+            s.free_bytes += size;
+            s.free_blocks++;
+            s.largest_free = MAX(s.largest_free, size);
+        } else {
+            s.used_bytes += size;
+            s.used_blocks++;
+        }
+    }
+    if (s.free_bytes) {
+        s.fragmentation = 1.0f - (f32) s.largest_free / (f32) s.free_bytes;
+    }
+    return s;
+}
+
+/* Slabs */
+#define SLAB_START next_alignment(0, sizeof(Slab), LCF_MEMORY_CACHE_LINE)
+#define SLAB_HALF (LCF_MEMORY_SLAB_MAGAZINE/2)
+
+internal u32 _Slab_class(u64 size) {
+    u32 result = 0;
+    if (size > 16) {
+        /* 2^k < size <= 2^(k+1), then pick 1.5*2^k or 2^(k+1) */
+        u32 k = bit_scan_reverse_u64(size - 1);
+        result = (size <= ((u64) 3 << (k-1)))? 2*(k-4) + 1 : 2*(k-3);
+    }
+    return result;
+}
+
+internal u32 _Slab_class_size(u32 size_class) {
+    return (size_class & 1)? 24u << (size_class/2) : 16u << (size_class/2);
+}
+
+internal Slab* _Slab_of(void *ptr) {
+    return (Slab*) ((upr) ptr & ~(upr) (LCF_MEMORY_SLAB_SIZE-1));
+}
+
+internal void _Slab_push(Slab **list, Slab *s) {
+    s->prev = 0;
+    s->next = *list;
+    if (*list) {
+        (*list)->prev = s;
+    }
+    *list = s;
+}
+
+internal void _Slab_unlink(Slab **list, Slab *s) {
+    if (s->prev) {
+        s->prev->next = s->next;
+    } else {
+        *list = s->next;
+    }
+    if (s->next) {
+        s->next->prev = s->prev;
+    }
+}
+
+/* Moves slots freed by other threads to the local free list, only called by the owner */
+internal void _Slab_collect(Slab *s) {
+    u64 head = ATOMIC_LOAD_U64(&s->remote_free);
+    if (head) {
+        while (!ATOMIC_CAS_U64(&s->remote_free, head, 0)) {
+            head = ATOMIC_LOAD_U64(&s->remote_free);
+        }
+        SlabSlot *slot = (SlabSlot*) (upr) head;
+        while (slot) {
+            SlabSlot *next = slot->next;
+            slot->next = s->free;
+            s->free = slot;
+            s->used--;
+            slot = next;
+        }
+    }
+}
+
+internal void _SlabHeap_lock(SlabHeap *h) {
+    while (!ATOMIC_CAS_U64(&h->lock, 0, 1)) {
+        CPU_PAUSE();
+    }
+}
+
+internal void _SlabHeap_unlock(SlabHeap *h) {
+    ASSERTM(ATOMIC_LOAD_U64(&h->lock) == 1, "SlabHeap unlocked twice.");
+    ATOMIC_STORE_U64(&h->lock, 0);
+}
+
+SlabHeap* SlabHeap_create(Arena *a) {
+    SlabHeap *h = Arena_take_struct_zero(a, SlabHeap);
+    h->arena = a;
+    return h;
+}
+
+/* Adopts an abandoned slab of the class, or starts a new one */
+internal Slab* _SlabHeap_get(SlabHeap *h, u32 size_class, SlabCache *owner) {
+    Slab *s = 0;
+    _SlabHeap_lock(h);
+    if (h->abandoned[size_class]) {
+        s = h->abandoned[size_class];
+        _Slab_unlink(&h->abandoned[size_class], s);
+    } else {
+        if (h->empty) {
+            s = h->empty;
+            h->empty = s->next;
+        } else {
+            s = (Slab*) Arena_take_custom(h->arena, LCF_MEMORY_SLAB_SIZE, LCF_MEMORY_SLAB_SIZE);
+            h->slabs++;
+        }
+        memset(s, 0, sizeof(Slab));
+        s->size_class = size_class;
+        s->slot_size = _Slab_class_size(size_class);
+        s->bump = (u8*) s + SLAB_START;
+    }
+    s->owner = (u64) (upr) owner;
+    s->full = 0;
+    _SlabHeap_unlock(h);
+    return s;
+}
+
+void SlabCache_begin(SlabCache *c, SlabHeap *h) {
+    memset(c, 0, sizeof(SlabCache));
+    c->heap = h;
+}
+
+internal Slab* _SlabCache_next_slab(SlabCache *c, u32 size_class) {
+    /* Full slabs may have had slots freed by other threads since */
+    for (Slab *s = c->full[size_class]; s; s = s->next) {
+        if (ATOMIC_LOAD_U64(&s->remote_free)) {
+            _Slab_unlink(&c->full[size_class], s);
+            _Slab_push(&c->slabs[size_class], s);
+            s->full = 0;
+            return s;
+        }
+    }
+    Slab *s = _SlabHeap_get(c->heap, size_class, c);
+    _Slab_push(&c->slabs[size_class], s);
+    return s;
+}
+
+/* Fills the magazine halfway from the owned slabs */
+internal void _SlabCache_refill(SlabCache *c, u32 size_class) {
+    SlabMagazine *m = c->magazine + size_class;
+    while (m->count < SLAB_HALF) {
+        Slab *s = c->slabs[size_class];
+        if (!s) {
+            s = _SlabCache_next_slab(c, size_class);
+        }
+        _Slab_collect(s);
+
+        u8 *end = (u8*) s + LCF_MEMORY_SLAB_SIZE;
+        while (m->count < SLAB_HALF && s->free) {
+            m->slot[m->count++] = s->free;
+            s->free = s->free->next;
+            s->used++;
+        }
+        while (m->count < SLAB_HALF && s->bump + s->slot_size <= end) {
+            m->slot[m->count++] = s->bump;
+            s->bump += s->slot_size;
+            s->used++;
+        }
+
+        if (!s->free && s->bump + s->slot_size > end) {
+            _Slab_unlink(&c->slabs[size_class], s);
+            _Slab_push(&c->full[size_class], s);
+            s->full = 1;
+        }
+    }
+}
+
+/* Returns the oldest count slots of the magazine to their slabs */
+internal void _SlabCache_flush(SlabCache *c, u32 size_class, u32 count) {
+    SlabMagazine *m = c->magazine + size_class;
+    for (u32 i = 0; i < count; i++) {
+        SlabSlot *slot = (SlabSlot*) m->slot[i];
+        Slab *s = _Slab_of(slot);
+        slot->next = s->free;
+        s->free = slot;
+        s->used--;
+
+        if (s->full) {
+            _Slab_unlink(&c->full[size_class], s);
+            _Slab_push(&c->slabs[size_class], s);
+            s->full = 0;
+        }
+        /* Keep one slab per class, give other empty ones back so any class can use them */
+        if (s->used == 0 && (s->prev || s->next)) {
+            _Slab_unlink(&c->slabs[size_class], s);
+            s->owner = 0;
+            _SlabHeap_lock(c->heap);
+            s->next = c->heap->empty;
+            c->heap->empty = s;
+            _SlabHeap_unlock(c->heap);
+        }
+    }
+    memmove(m->slot, m->slot + count, (m->count - count)*sizeof(void*));
+    m->count -= count;
+}
+
+void SlabCache_end(SlabCache *c) {
+    SlabHeap *h = c->heap;
+    for (u32 k = 0; k < SLAB_CLASS_COUNT; k++) {
+        _SlabCache_flush(c, k, c->magazine[k].count);
+
+        Slab **lists[2] = { &c->slabs[k], &c->full[k] };
+        for (u32 l = 0; l < 2; l++) {
+            while (*lists[l]) {
+                Slab *s = *lists[l];
+                _Slab_unlink(lists[l], s);
+                _Slab_collect(s);
+                s->owner = 0;
+                _SlabHeap_lock(h);
+                if (s->used == 0) {
+                    s->next = h->empty;
+                    h->empty = s;
+                } else {
+                    _Slab_push(&h->abandoned[k], s);
+                }
+                _SlabHeap_unlock(h);
+            }
+        }
+    }
+}
+
+void* SlabCache_take(SlabCache *c, u64 size) {
+    ASSERTM(size <= SLAB_MAX_SIZE, "Too big for a slab, use a Heap or an Arena.");
+    u32 size_class = _Slab_class(size);
+    SlabMagazine *m = c->magazine + size_class;
+    if (!m->count) {
+        _SlabCache_refill(c, size_class);
+    }
+    return m->slot[--m->count];
+}
+
+void* SlabCache_take_zero(SlabCache *c, u64 size) {
+    void *mem = SlabCache_take(c, size);
+    memset(mem, 0, size);
+    return mem;
+}
+
+void SlabCache_free(SlabCache *c, void *ptr) {
+    if (ptr) {
+        Slab *s = _Slab_of(ptr);
+        if (LCF_MEMORY_DEBUG_CLEAR) {
+            memset(ptr, LCF_MEMORY_ARENA_CLEAR, s->slot_size);
+        }
+        
+        if (s->owner == (u64) (upr) c) {
+            SlabMagazine *m = c->magazine + s->size_class;
+            if (m->count == LCF_MEMORY_SLAB_MAGAZINE) {
+                _SlabCache_flush(c, s->size_class, SLAB_HALF);
+            }
+            m->slot[m->count++] = ptr;
+        } else {
+            SlabSlot *slot = (SlabSlot*) ptr;
+            u64 head;
+            do {
+                head = ATOMIC_LOAD_U64(&s->remote_free);
+                slot->next = (SlabSlot*) (upr) head;
+            } while (!ATOMIC_CAS_U64(&s->remote_free, head, (upr) slot));
+        }
+    }
+}
+
+u64 Slab_slot_size(void *ptr) {
+    return _Slab_of(ptr)->slot_size;
+}
+
+#undef SLAB_START
+#undef SLAB_HALF
+#undef HEAP_BLOCK_FREE
+#undef HEAP_BLOCK_PREV_FREE
+#undef HEAP_BLOCK_FLAGS
+#undef HEAP_ALIGN
+#undef HEAP_BLOCK_OVERHEAD
+#undef HEAP_BLOCK_START
+#undef HEAP_BLOCK_MIN
+#undef HEAP_BLOCK_MAX
+#undef HEAP_SMALL_BLOCK
@@ -0,0 +1,160 @@
+#if !defined(LCF_HEAP)
+#define LCF_HEAP "1.0.0"
+
+#include "lcf_types.h"
+#include "lcf_memory.h"
+
+/* Heap
+   General purpose allocator for things with mixed lifetimes that don't fit in an Arena.
+   Two-Level Segregated Fit (TLSF): free blocks are binned by size into HEAP_FL_COUNT classes of
+   powers of two, each split into HEAP_SL_COUNT linear subclasses. Two levels of bitmaps find a
+   big enough block with a couple of bit scans, so alloc and free are O(1) with no searching.
+   Neighbouring free blocks are merged on free.
+
+   Like an Arena, the Heap reserves its whole size up front and commits at the end as it grows,
+   doubling the step up to LCF_MEMORY_COMMIT_GROW_MAX. Single threaded.
+
+   REF(lcf) http://www.gii.upv.es/tlsf/files/papers/ecrts04_tlsf.pdf
+ */
+#if !defined(LCF_MEMORY_HEAP_SIZE)
+ #define LCF_MEMORY_HEAP_SIZE GB(1)
+#endif
+
+#define HEAP_SL_LOG2 5
+#define HEAP_SL_COUNT (1 << HEAP_SL_LOG2)
+#define HEAP_ALIGN_LOG2 3
+#define HEAP_FL_SHIFT (HEAP_SL_LOG2 + HEAP_ALIGN_LOG2)
+#define HEAP_FL_MAX 40 /* Largest block is 1 TB */
+#define HEAP_FL_COUNT (HEAP_FL_MAX - HEAP_FL_SHIFT + 1)
+
+/* Physical neighbours are found through size and prev_phys. prev_phys lives at the end of the
+   previous block and is only valid when that block is free. The free links overlap the memory
+   given to the user, so a used block only costs the size field. */
+struct HeapBlock {
+    struct HeapBlock *prev_phys;
+    u64 size; /* Low bits are HEAP_BLOCK_FREE and HEAP_BLOCK_PREV_FREE */
+    struct HeapBlock *next_free;
+    struct HeapBlock *prev_free;
+};
+typedef struct HeapBlock HeapBlock;
+
+struct Heap {
+    u64 size;
+    u64 commit_pos;
+    u32 commit_size;
+    u32 alignment;
+    u64 commits;
+
+    HeapBlock *first;
+    HeapBlock *last; /* Zero sized sentinel at the end of the committed memory */
+    u64 fl_bitmap;
+    u32 sl_bitmap[HEAP_FL_COUNT];
+    HeapBlock *free[HEAP_FL_COUNT][HEAP_SL_COUNT];
+};
+typedef struct Heap Heap;
+
+Heap* Heap_create_custom(u64 size, u32 commit_size, u32 alignment);
+#define Heap_create() Heap_create_custom(LCF_MEMORY_HEAP_SIZE, (u32) LCF_MEMORY_COMMIT_SIZE, (u32) LCF_MEMORY_ALIGNMENT)
+void Heap_destroy(Heap *h);
+
+void* Heap_alloc(Heap *h, u64 size);
+void* Heap_alloc_custom(Heap *h, u64 size, u32 alignment);
+void* Heap_alloc_zero(Heap *h, u64 size);
+void* Heap_realloc(Heap *h, void *ptr, u64 size); /* Keeps the default alignment only */
+void Heap_free(Heap *h, void *ptr);
+u64 Heap_block_size(void *ptr); /* Usable size of an allocation, can be more than asked for */
+#define Heap_alloc_array(h, type, count) ((type*) Heap_alloc(h, sizeof(type)*(count)))
+#define Heap_alloc_struct(h, type) ((type*) Heap_alloc(h, sizeof(type)))
+#define Heap_alloc_struct_zero(h, type) ((type*) Heap_alloc_zero(h, sizeof(type)))
+
+/* Walks every block, so this is O(blocks). fragmentation is 1 - largest_free/free_bytes:
+   0 when all free memory is in one block, near 1 when it is scattered in small pieces. */
+struct HeapStats {
+    u64 committed;
+    u64 used_bytes;
+    u64 used_blocks;
+    u64 free_bytes;
+    u64 free_blocks;
+    u64 largest_free;
+    u64 commits;
+    f32 fragmentation;
+};
+typedef struct HeapStats HeapStats;
+
+HeapStats Heap_stats(Heap *h);
+
+/* Slabs
+   For lots of small objects of different sizes, shared between threads. Sizes are rounded up
+   to one of SLAB_CLASS_COUNT classes (16, 24, 32, 48, ... 3072, 4096), and each class takes its
+   slots from slabs of LCF_MEMORY_SLAB_SIZE carved out of an Arena. Slabs are aligned to their
+   size so the slab of any slot is found by masking the pointer.
+
+   Every thread allocates through its own SlabCache, which owns slabs and keeps a magazine of
+   free slots per class, so the common take and free touch no shared state. Freeing a slot owned
+   by another thread's cache pushes it onto that slab's remote free list with a CAS, and the
+   owner collects the whole list when it runs out of slots. SlabCache_end gives back the magazines
+   and leaves the slabs still in use for another cache to adopt.
+ */
+#if !defined(LCF_MEMORY_SLAB_SIZE)
+ #define LCF_MEMORY_SLAB_SIZE KB(64) /* Must be a power of 2 */
+#endif
+#if !defined(LCF_MEMORY_SLAB_MAGAZINE)
+ #define LCF_MEMORY_SLAB_MAGAZINE 64
+#endif
+
+#define SLAB_CLASS_COUNT 17
+#define SLAB_MAX_SIZE 4096
+
+struct SlabSlot {
+    struct SlabSlot *next;
+};
+typedef struct SlabSlot SlabSlot;
+
+struct Slab {
+    struct Slab *next;
+    struct Slab *prev;
+    u64 owner; /* SlabCache taking from this slab, 0 when abandoned */
+    u64 remote_free; /* SlabSlot* list pushed by other threads */
+    SlabSlot *free;
+    u8 *bump; /* Slots past here were never taken */
+    u32 slot_size;
+    u32 size_class;
+    u32 used; /* Slots out of the slab, including those in magazines and remote lists */
+    u32 full;
+};
+typedef struct Slab Slab;
+
+struct SlabHeap {
+    Arena *arena;
+    u64 lock;
+    Slab *empty;
+    Slab *abandoned[SLAB_CLASS_COUNT];
+    u64 slabs; /* carved from the arena so far */
+};
+typedef struct SlabHeap SlabHeap;
+
+struct SlabMagazine {
+    u32 count;
+    void *slot[LCF_MEMORY_SLAB_MAGAZINE];
+};
+typedef struct SlabMagazine SlabMagazine;
+
+struct SlabCache {
+    SlabHeap *heap;
+    Slab *slabs[SLAB_CLASS_COUNT]; /* with free slots */
+    Slab *full[SLAB_CLASS_COUNT];
+    SlabMagazine magazine[SLAB_CLASS_COUNT];
+};
+typedef struct SlabCache SlabCache;
+
+SlabHeap* SlabHeap_create(Arena *a);
+void SlabCache_begin(SlabCache *c, SlabHeap *h);
+void SlabCache_end(SlabCache *c);
+void* SlabCache_take(SlabCache *c, u64 size);
+void* SlabCache_take_zero(SlabCache *c, u64 size);
+void SlabCache_free(SlabCache *c, void *ptr); /* ptr can come from any SlabCache on the same SlabHeap */
+u64 Slab_slot_size(void *ptr);
+#define SlabCache_take_struct(c, type) ((type*) SlabCache_take(c, sizeof(type)))
+#define SlabCache_take_struct_zero(c, type) ((type*) SlabCache_take_zero(c, sizeof(type)))
+
+#endif
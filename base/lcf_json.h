@@ -32,9 +32,9 @@ struct json_token {
 typedef struct json_token json_token;
 
 struct json {
-    Arena *arena;
     str input; 
     
+    VArray token_array; /* tokens never move, free with json_free */
     json_token *token;
     s64 c; // cursor
     s32 tokens;
@@ -57,18 +57,27 @@ static s32 _json_next_tok(json *j) {
         j->token[t->parent].n++;
     }
     s32 r = j->tokens++;
-    Arena_take_struct_zero(j->arena, json_token);
+    if (!VArray_push(&j->token_array)) {
+        j->err = 1; // out of memory
+    }
     
     return r;
 }
 
+/* Tokens go in j->token_array, which json_parse reserves on the first call and the caller
+   owns: release it with json_free once done with the tokens. Every token takes at least one
+   char of input, so reserving input.len + 2 (the root and the slot for the next token) never
+   runs out, and only the pages actually used are committed. */
 static s32 json_parse(json *j) {
     str s = str_skip(j->input, j->c);
 
     if (j->tokens == 0) {
         j->tokens++;
-        j->token = Arena_take_struct_zero(j->arena, json_token);
-        Arena_take_struct_zero(j->arena, json_token);
+        if (!j->token_array.data) {
+            j->token_array = VArray_create(json_token, (u64) j->input.len + 2);
+        }
+        j->token = VArray_push_struct(&j->token_array, json_token);
+        VArray_push(&j->token_array);
     }
     
     while (s.len > 0) {
@@ -175,20 +184,11 @@ static s32 json_parse(json *j) {
                 
                 s32 found_exp = 0;
                 for (; i < s.len; i++) {
-                    char c1 = s.str[i];
-                    if (c1 == '0'
-                        || c1 == '1'
-                        || c1 == '2'
-                        || c1 == '3'
-                        || c1 == '4'
-                        || c1 == '5'
-                        || c1 == '6'
-                        || c1 == '7'
-                        || c1 == '8'
-                        || c1 == '9'
-                    ) {
-                        continue;
+                    i += (s32) str_count_digits(str_skip(s, i), (f & JSON_NUM_HEX)? 16 : 10);
+                    if (i >= s.len) {
+                        break;
                     }
+                    char c1 = s.str[i];
 
                     if (c1 == '.') {
                         if (!((f & JSON_NUM_FLOAT) > 0)) {
@@ -204,18 +204,6 @@ static s32 json_parse(json *j) {
                     }
 
                     c1 |= 32; // make case insensitive
-                    if (f & JSON_NUM_HEX) {
-                        if (c1 == 'a'
-                        || c1 == 'b'
-                        || c1 == 'c'
-                        || c1 == 'd'
-                        || c1 == 'e'
-                        || c1 == 'f'
-                        ) {
-                            continue;
-                        }
-                    }
-
                     if (f & JSON_NUM_HEX) {
                         if (c1 == 'p') {
                             if (!found_exp) {
@@ -316,6 +304,12 @@ static s32 json_parse(json *j) {
     return j->err;
 }
 
+static void json_free(json *j) {
+    VArray_destroy(&j->token_array);
+    j->token = 0;
+    j->tokens = 0;
+}
+
 static json_token* json_next(json *j, json_token *root, json_token *prev) {
     s32 r = (root)? (s32)(root - j->token) : 0;
     s32 i = 1 + ((prev)? (s32)(prev - j->token) : r);
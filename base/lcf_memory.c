@@ -20,27 +20,153 @@ internal u64 next_alignment(u8* mem, u64 offset, u64 alignment) {
     return ptr - (upr) mem;
 }
 
-Arena* Arena_create_custom(Arena params) {
+#if LCF_MEMORY_INSTRUMENT
+internal void _ArenaStats_register(Arena *a);
+internal void _ArenaStats_unregister(Arena *a);
+internal void _ArenaStats_take(Arena *a, u64 size, u64 pos);
+internal void _ArenaStats_commit(Arena *a, u64 commit_pos);
+#endif
+internal void _ArenaSnapshot_release(Arena *a, u64 real_pos);
+
+/* Creates a single block, chained arenas create more with this */
+internal Arena* _Arena_create_block(Arena params) {
     ASSERT(is_power_of_2(params.commit_size));
+
+    Arena* a = 0;
+    u64 reserve_size = 0;
+    u64 pos = 0;
+    if (params.flags & ARENA_FILE) {
+        ASSERTM(!(params.flags & ARENA_CHAINED), "File arenas can't be chained.");
+        params.flags &= ~ARENA_LARGE_PAGES;
+        reserve_size = next_alignment(0, params.size, params.commit_size);
+        a = (Arena*) LCF_MEMORY_map_file(params.file, reserve_size);
+        if (!a) {
+            return 0;
+        }
+        /* An existing file arena of the same size, keep what is in it */
+        if ((a->flags & ARENA_FILE) && a->size == reserve_size) {
+            pos = a->pos;
+        }
+    }
+
+    if (params.flags & ARENA_LARGE_PAGES) {
+        /* Commits have to be whole large pages */
+        u64 large_page = LCF_MEMORY_LARGE_PAGE_SIZE;
+        reserve_size = next_alignment(0, params.size, large_page);
+        a = (Arena*) LCF_MEMORY_reserve_large(reserve_size);
+        if (a) {
+            params.commit_size = (u32) MAX(params.commit_size, large_page);
+        } else {
+            params.flags &= ~ARENA_LARGE_PAGES;
+        }
+    }
     
-    u64 reserve_size = next_alignment(0, params.size, params.commit_size);
-    Arena* a = (Arena*) LCF_MEMORY_reserve(reserve_size);
+    if (!a) {
+        reserve_size = next_alignment(0, params.size, params.commit_size);
+        a = (Arena*) LCF_MEMORY_reserve(reserve_size);
+    }
+
+    /* Bind before anything is committed so every page is first touched on the node */
+    if ((params.flags & ARENA_NUMA) && ((params.flags & ARENA_FILE) || !LCF_MEMORY_bind_node(a, reserve_size, params.numa_node))) {
+        params.flags &= ~ARENA_NUMA;
+    }
 
     u64 commit_pos = params.commit_pos? next_alignment((u8*) a, params.commit_pos, params.commit_size) : params.commit_size;
-    LCF_MEMORY_commit(a, commit_pos);
+    if (params.flags & (ARENA_COMMIT_ALL | ARENA_FILE)) {
+        commit_pos = reserve_size;
+    }
+    if (!(params.flags & ARENA_FILE)) {
+        LCF_MEMORY_commit(a, commit_pos);
+    }
+    if (params.flags & ARENA_COMMIT_PREFAULT) {
+        LCF_MEMORY_prefault(a, commit_pos);
+    }
     
     *a = params;
-    a->pos = 0;
+    LCF_MEMORY_POISON(Arena_mem_start(a) + pos, commit_pos - sizeof(Arena) - pos);
+    a->commits = 1;
+    a->decommits = 0;
+    a->protect_end = 0;
+    a->resets_below = 0;
+    a->peak_pos = 0;
+    a->pos = pos;
     a->commit_pos = commit_pos;
     a->size = reserve_size;
+    a->base_pos = 0;
+    a->current = a;
+    a->prev = 0;
+    a->free = 0;
+    a->snapshot = 0;
+    return a;
+}
+
+Arena* (Arena_create_custom)(Arena params) {
+    Arena *a = _Arena_create_block(params);
+    #if LCF_MEMORY_INSTRUMENT
+    _ArenaStats_register(a);
+    #endif
     return a;
 }
 
+/* Unpoisoned first, ASan would otherwise still flag whatever gets mapped there next */
+internal void _Arena_free_block(Arena *block) {
+    LCF_MEMORY_UNPOISON(block, MAX(block->commit_pos, block->protect_end));
+    LCF_MEMORY_free(block, block->size);
+}
+
 void Arena_destroy(Arena *a) {
-    LCF_MEMORY_free(a, a->size);
+    Arena_snapshot_end(a);
+    #if LCF_MEMORY_INSTRUMENT
+    _ArenaStats_unregister(a);
+    #endif
+
+    Arena *block = a->current;
+    while (block != a) {
+        Arena *prev = block->prev;
+        _Arena_free_block(block);
+        block = prev;
+    }
+    block = a->free;
+    while (block) {
+        Arena *prev = block->prev;
+        _Arena_free_block(block);
+        block = prev;
+    }
+    if (a->flags & ARENA_FILE) {
+        LCF_MEMORY_UNPOISON(a, a->size);
+        LCF_MEMORY_unmap_file(a->file, a, a->size, sizeof(Arena) + a->pos);
+    } else {
+        _Arena_free_block(a);
+    }
+}
+
+/* Picks the commit_pos to grow to for an arena that needs real_pos committed */
+internal u64 _Arena_next_commit_pos(Arena *a, u64 commit_pos, u64 real_pos) {
+    u64 target = real_pos;
+    if (a->flags & ARENA_COMMIT_GROW) {
+        u64 step = (u64) a->commit_size << MIN(a->commits, 32);
+        step = MIN(step, MAX(LCF_MEMORY_COMMIT_GROW_MAX, a->commit_size));
+        target = MAX(real_pos, commit_pos + step);
+    }
+    return MIN(next_alignment((u8*) a, target, a->commit_size), a->size);
+}
+
+/* Commits the range [commit_pos, new_commit_pos) of the block */
+internal s32 _Arena_commit(Arena *a, u64 commit_pos, u64 new_commit_pos) {
+    u8 *mem = (u8*) a + commit_pos;
+    s32 result = LCF_MEMORY_commit(mem, new_commit_pos - commit_pos);
+    if (result && (a->flags & ARENA_COMMIT_PREFAULT)) {
+        LCF_MEMORY_prefault(mem, new_commit_pos - commit_pos);
+    }
+    ATOMIC_ADD_U64(&a->commits, 1);
+    #if LCF_MEMORY_INSTRUMENT
+    _ArenaStats_commit(a, new_commit_pos);
+    #endif
+    return result;
 }
 
-void* Arena_take_custom(Arena *a, u64 size, u32 alignment) {
+/* Takes from a single block, returns 0 if the block has no space left */
+internal void* _Arena_take_block(Arena *a, u64 size, u32 alignment) {
     void* result = 0;
     
     /* Align pos pointer */
@@ -54,68 +180,464 @@ void* Arena_take_custom(Arena *a, u64 size, u32 alignment) {
         /* Commit memory if needed */
         s32 in_commit_range = real_pos <= a->commit_pos;
         if (!in_commit_range) {
-            upr new_commit_pos = next_alignment((u8*) a, real_pos, a->commit_size);
-            in_commit_range = LCF_MEMORY_commit(a, new_commit_pos); 
+            u64 new_commit_pos = _Arena_next_commit_pos(a, a->commit_pos, real_pos);
+            in_commit_range = _Arena_commit(a, a->commit_pos, new_commit_pos); 
+            LCF_MEMORY_POISON((u8*) a + a->commit_pos, new_commit_pos - a->commit_pos);
             a->commit_pos = new_commit_pos;
         }
         if (in_commit_range) {
             result = mem + aligned_pos;
             a->pos = new_pos;
+            LCF_MEMORY_UNPOISON(result, size);
         }
     }
     
+    return result;
+}
+
+/* Links a block with space for size bytes onto a chained arena, reusing a cached block if
+   one is big enough. New blocks copy the settings of the first block. */
+internal Arena* _Arena_push_block(Arena *a, u64 size, u32 alignment) {
+    u64 needed = sizeof(Arena) + size + alignment;
+
+    Arena *block = 0;
+    for (Arena **f = &a->free; *f; f = &(*f)->prev) {
+        if ((*f)->size > needed) {
+            block = *f;
+            *f = block->prev;
+            break;
+        }
+    }
+
+    if (!block) {
+        Arena params = *a;
+        params.size = MAX(a->size, needed);
+        params.commit_pos = 0;
+        block = _Arena_create_block(params);
+    }
+
+    if (block) {
+        Arena *last = a->current;
+        block->pos = 0;
+        block->base_pos = last->base_pos + (last->size - sizeof(Arena));
+        block->prev = last;
+        a->current = block;
+    }
+    return block;
+}
+
+void* (Arena_take_custom)(Arena *a, u64 size, u32 alignment) {
+    void* result = _Arena_take_block(a->current, size, alignment);
+
+    if (!result && (a->flags & ARENA_CHAINED)) {
+        Arena *block = _Arena_push_block(a, size, alignment);
+        if (block) {
+            result = _Arena_take_block(block, size, alignment);
+        }
+    }
+    
+    #if LCF_MEMORY_INSTRUMENT
+    _ArenaStats_take(a, size, Arena_pos(a));
+    #endif
     ASSERT(result); // Arena out of memory!
     return result;
 }
 
-inline void* Arena_take(Arena *a, u64 size) {
-    return Arena_take_custom(a, size, a->alignment);
+inline void* (Arena_take)(Arena *a, u64 size) {
+    return (Arena_take_custom)(a, size, a->alignment);
 }
 
-inline void* Arena_take_zero_custom(Arena *a, u64 size, u32 alignment) {
-    void* mem = Arena_take_custom(a, size, alignment);
+inline void* (Arena_take_zero_custom)(Arena *a, u64 size, u32 alignment) {
+    void* mem = (Arena_take_custom)(a, size, alignment);
     memset(mem, 0, size);
     return mem;
 }
 
-inline void* Arena_take_zero(Arena *a, u64 size) {
-    void* mem = Arena_take_custom(a, size, a->alignment);
+inline void* (Arena_take_zero)(Arena *a, u64 size) {
+    void* mem = (Arena_take_custom)(a, size, a->alignment);
     memset(mem, 0, size);
     return mem;
 }
 
-void Arena_reset(Arena *a, u64 pos) {
-    if (LCF_MEMORY_DEBUG_CLEAR) {
-        if (pos < a->pos) {
-            /* Clear memory between pos and a->pos */
-            memset(Arena_mem_start(a) + pos, LCF_MEMORY_ARENA_CLEAR, a->pos - pos);
+void* (Arena_take_atomic)(Arena *a, u64 size, u32 alignment) {
+    ASSERTM(!(a->flags & ARENA_CHAINED), "Chained arenas can't be taken from concurrently.");
+    void* result = 0;
+
+    /* Take enough extra that whatever pos we get back can be aligned */
+    u8 *mem = Arena_mem_start(a);
+    u64 pos = ATOMIC_ADD_U64(&a->pos, size + alignment - 1);
+    u64 aligned_pos = next_alignment(mem, pos, alignment);
+    u64 new_pos = aligned_pos + size;
+
+    /* Check that there is space */
+    u64 real_pos = new_pos + sizeof(Arena);
+    if (real_pos < a->size) {
+        result = mem + aligned_pos;
+
+        /* Commit memory if needed. Everything below commit_pos is committed, so each thread
+           only commits from the commit_pos it saw. If another thread moved it first just
+           check again, committing a range twice is harmless. */
+        u64 commit_pos = ATOMIC_LOAD_U64(&a->commit_pos);
+        while (real_pos > commit_pos) {
+            u64 new_commit_pos = _Arena_next_commit_pos(a, commit_pos, real_pos);
+            if (!_Arena_commit(a, commit_pos, new_commit_pos)) {
+                result = 0;
+                break;
+            }
+            if (ATOMIC_CAS_U64(&a->commit_pos, commit_pos, new_commit_pos)) {
+                break;
+            }
+            commit_pos = ATOMIC_LOAD_U64(&a->commit_pos);
         }
+        if (result) {
+            LCF_MEMORY_UNPOISON(result, size);
+        }
+    }
+
+    #if LCF_MEMORY_INSTRUMENT
+    _ArenaStats_take(a, size, new_pos);
+    #endif
+    ASSERT(result); // Arena out of memory!
+    return result;
+}
+
+ArenaTLAB ArenaTLAB_begin(Arena *a, u64 block_size) {
+    ArenaTLAB t = ZERO_STRUCT;
+    t.arena = a;
+    t.block_size = block_size? block_size : LCF_MEMORY_TLAB_SIZE;
+    return t;
+}
+
+void* (ArenaTLAB_take)(ArenaTLAB *t, u64 size, u32 alignment) {
+    void* result = 0;
+    if (size > t->block_size/2) {
+        result = (Arena_take_atomic)(t->arena, size, alignment);
+    } else {
+        u8 *aligned = t->pos + next_alignment(t->pos, 0, alignment);
+        if (!t->pos || aligned + size > t->end) {
+            /* Blocks are cache line aligned so threads don't share lines */
+            t->pos = (u8*) (Arena_take_atomic)(t->arena, t->block_size, LCF_MEMORY_CACHE_LINE);
+            t->end = t->pos + t->block_size;
+            aligned = t->pos + next_alignment(t->pos, 0, alignment);
+        }
+        result = aligned;
+        t->pos = aligned + size;
+    }
+    return result;
+}
+
+u64 Arena_pos(Arena *a) {
+    return a->current->base_pos + a->current->pos;
+}
+
+u64 Arena_peak(Arena *a) {
+    return MAX(a->peak_pos, Arena_pos(a));
+}
+
+void* (Arena_grow)(Arena *a, void *ptr, u64 old_size, u64 new_size) {
+    if (!ptr) {
+        return (Arena_take)(a, new_size);
+    }
+    if (new_size <= old_size) {
+        Arena_shrink(a, ptr, old_size, new_size);
+        return ptr;
+    }
+
+    /* Top of the current block, the extra bytes are taken unaligned so they land right after */
+    Arena *block = a->current;
+    if (B_PTR(ptr) + old_size == Arena_mem_start(block) + block->pos &&
+        _Arena_take_block(block, new_size - old_size, 1)) {
+        #if LCF_MEMORY_INSTRUMENT
+        _ArenaStats_take(a, new_size - old_size, Arena_pos(a));
+        #endif
+        return ptr;
+    }
+
+    void *result = (Arena_take_custom)(a, new_size, a->alignment);
+    memcpy(result, ptr, old_size);
+    return result;
+}
+
+internal void _Arena_reset_block(Arena *a, u64 pos) {
+    if (pos < a->pos) {
+        u8 *mem = Arena_mem_start(a);
+        u64 clear_end = a->pos;
+
+        if (LCF_MEMORY_DEBUG_CLEAR == LCF_MEMORY_DEBUG_PROTECT && !(a->flags & ARENA_FILE)) {
+            /* Protect the whole pages that were in use. Lowering commit_pos to the first one
+               means taking the memory again commits it, which unprotects it. */
+            u64 protect_pos = next_alignment((u8*) a, pos + sizeof(Arena), a->commit_size);
+            u64 protect_end = next_alignment((u8*) a, a->pos + sizeof(Arena), a->commit_size);
+            if (a->snapshot && protect_pos < protect_end) {
+                _ArenaSnapshot_release(a, protect_pos);
+            }
+            if (protect_pos < protect_end && LCF_MEMORY_protect((u8*) a + protect_pos, protect_end - protect_pos)) {
+                a->protect_end = MAX(a->protect_end, a->commit_pos);
+                a->commit_pos = protect_pos;
+                clear_end = MIN(clear_end, protect_pos - sizeof(Arena));
+            }
+        }
+        
+        if (LCF_MEMORY_DEBUG_CLEAR) {
+            /* Clear memory between pos and a->pos, alignment padding in there is still poisoned */
+            LCF_MEMORY_UNPOISON(mem + pos, clear_end - pos);
+            memset(mem + pos, LCF_MEMORY_ARENA_CLEAR, clear_end - pos);
+        }
+        LCF_MEMORY_POISON(mem + pos, a->pos - pos);
     }
     a->pos = pos;
 }
 
+void Arena_shrink(Arena *a, void *ptr, u64 old_size, u64 new_size) {
+    Arena *block = a->current;
+    u8 *mem = Arena_mem_start(block);
+    if (new_size < old_size && B_PTR(ptr) + old_size == mem + block->pos) {
+        a->peak_pos = MAX(a->peak_pos, Arena_pos(a));
+        _Arena_reset_block(block, (u64)(B_PTR(ptr) - mem) + new_size);
+    }
+}
+
+void Arena_reset(Arena *a, u64 pos) {
+    u64 old_pos = Arena_pos(a);
+    a->peak_pos = MAX(a->peak_pos, old_pos);
+    
+    /* Release blocks that start past pos to the cache */
+    Arena *block = a->current;
+    while (block->prev && block->base_pos > pos) {
+        Arena *prev = block->prev;
+        _Arena_reset_block(block, 0);
+        block->prev = a->free;
+        a->free = block;
+        block = prev;
+    }
+    a->current = block;
+    _Arena_reset_block(block, pos - block->base_pos);
+
+    /* Automatic decommit, only once the arena has stayed under decommit_pos for a while */
+    if (a->decommit_pos) {
+        if (old_pos > a->decommit_pos) {
+            a->resets_below = 0;
+        } else if (++a->resets_below >= a->decommit_resets) {
+            Arena_decommit(a, MAX(a->decommit_pos, pos));
+            a->resets_below = 0;
+        }
+    }
+}
+
+/* Decommits a block past pos, always keeping the header and the first commit */
+internal void _Arena_decommit_block(Arena *a, u64 pos) {
+    if (a->flags & ARENA_FILE) {
+        return; /* Would drop the file's pages */
+    }
+    u64 real_pos = MAX(pos + sizeof(Arena), a->commit_size);
+    u64 new_commit_pos = next_alignment((u8*) a, real_pos, a->commit_size);
+    u64 committed = MAX(a->commit_pos, a->protect_end);
+    if (committed > new_commit_pos) {
+        if (a->snapshot) {
+            _ArenaSnapshot_release(a, new_commit_pos);
+        }
+        LCF_MEMORY_UNPOISON((u8*) a + new_commit_pos, committed - new_commit_pos);
+        LCF_MEMORY_decommit((u8*) a + new_commit_pos, committed - new_commit_pos);
+        a->protect_end = (a->commit_pos < new_commit_pos)? new_commit_pos : 0;
+        a->commit_pos = MIN(a->commit_pos, new_commit_pos);
+        a->decommits++;
+    }
+}
+
 void Arena_decommit(Arena *a, u64 needed_pos) {
-    u8 *mem = Arena_mem_start(a);
-    if (!needed_pos) {
-        /* Decommit everything except what is needed, or one page */
-        needed_pos = MAX(a->pos, a->commit_size);
-    } else {
+    Arena *block = a->current;
+    u64 pos = block->pos;
+    if (needed_pos) {
         /* Should never decommit currently in use memory! */
-        ASSERT(needed_pos > a->pos);
+        ASSERT(needed_pos >= Arena_pos(a));
+        pos = needed_pos - block->base_pos;
     }
-    
-    u64 new_commit_pos = next_alignment(mem, needed_pos, a->commit_size);
-    u64 over_commited = a->commit_pos - new_commit_pos;
-    if (over_commited >= a->commit_size) {
-        LCF_MEMORY_decommit(mem+new_commit_pos, over_commited);
-        a->commit_pos = new_commit_pos;
+    _Arena_decommit_block(block, pos);
+
+    /* Cached blocks aren't in use at all */
+    for (block = a->free; block; block = block->prev) {
+        _Arena_decommit_block(block, 0);
+    }
+}
+
+/* Snapshots */
+#define SNAPSHOT_DIRTY(s, page) ((s)->dirty[(page) >> 6] & (1ull << ((page) & 63)))
+
+/* Pages from real_pos on lost their contents or protection, stop watching them and copy them
+   all on restore */
+internal void _ArenaSnapshot_release(Arena *a, u64 real_pos) {
+    ArenaSnapshot *s = a->snapshot;
+    u64 page = real_pos / s->page_size;
+    if (page < s->released) {
+        s->released = page;
+        if (s->watching) {
+            LCF_MEMORY_watch_writes(a, s->released * s->page_size, s->page_size, s->dirty);
+        }
+    }
+}
+
+/* Sets write protection on the runs of pages in [first, last) that are dirty, or clean */
+internal void _ArenaSnapshot_protect(Arena *a, u64 first, u64 last, s32 dirty, s32 writable) {
+    ArenaSnapshot *s = a->snapshot;
+    u64 page = first;
+    while (page < last) {
+        while (page < last && !SNAPSHOT_DIRTY(s, page) != !dirty) {
+            page++;
+        }
+        u64 run = page;
+        while (page < last && !SNAPSHOT_DIRTY(s, page) == !dirty) {
+            page++;
+        }
+        if (run < page) {
+            LCF_MEMORY_protect_writes((u8*) a + run * s->page_size, (page - run) * s->page_size, writable);
+        }
+    }
+}
+
+/* Copies page from one copy of the arena to the other, only up to real_pos */
+internal void _ArenaSnapshot_copy(u8 *to, u8 *from, u64 page, u64 page_size, u64 real_pos) {
+    u64 start = page * page_size;
+    u64 end = MIN(start + page_size, real_pos);
+    if (start < end) {
+        memcpy(to + start, from + start, end - start);
+    }
+}
+
+ArenaSnapshot* Arena_snapshot(Arena *a) {
+    ASSERTM(!(a->flags & ARENA_CHAINED), "Chained arenas can't be snapshot.");
+    ArenaSnapshot *s = a->snapshot;
+    u64 page_size = a->commit_size;
+    if (!s) {
+        u64 bitmap_size = ((a->size / page_size + 63) / 64) * sizeof(u64);
+        u64 size = next_alignment(0, sizeof(ArenaSnapshot) + bitmap_size, LCF_MEMORY_COMMIT_SIZE);
+        s = (ArenaSnapshot*) LCF_MEMORY_reserve(size);
+        if (!s || !LCF_MEMORY_commit(s, size)) {
+            return 0;
+        }
+        memset(s, 0, size);
+        s->size = size;
+        s->page_size = page_size;
+        s->dirty = (u64*) (s + 1);
+        s->watching = 1;
+        s->shadow = (u8*) LCF_MEMORY_reserve(a->size);
+        if (!s->shadow) {
+            LCF_MEMORY_free(s, size);
+            return 0;
+        }
+        a->snapshot = s;
+    }
+
+    u64 real_pos = sizeof(Arena) + a->pos;
+    u64 pages = (real_pos + page_size - 1) / page_size;
+    if (pages * page_size > s->shadow_commit) {
+        if (!LCF_MEMORY_commit(s->shadow + s->shadow_commit, pages * page_size - s->shadow_commit)) {
+            return 0;
+        }
+        s->shadow_commit = pages * page_size;
+    }
+
+    /* Alignment padding gets copied too */
+    LCF_MEMORY_UNPOISON(Arena_mem_start(a), a->pos);
+    s->copied = 0;
+    for (u64 page = 0; page < pages; page++) {
+        if (!s->watching || page >= s->released || SNAPSHOT_DIRTY(s, page)) {
+            _ArenaSnapshot_copy(s->shadow, (u8*) a, page, page_size, real_pos);
+            s->copied++;
+        }
+    }
+
+    if (s->watching) {
+        /* Pages past the new end that were never written are still read only */
+        _ArenaSnapshot_protect(a, pages, s->released, 0, 1);
+        s->watching = LCF_MEMORY_watch_writes(a, pages * page_size, page_size, s->dirty);
     }
+    if (s->watching) {
+        for (u64 page = s->released; page < pages; page++) {
+            s->dirty[page >> 6] |= 1ull << (page & 63);
+        }
+        _ArenaSnapshot_protect(a, 0, pages, 1, 0);
+        memset(s->dirty, 0, ((MAX(pages, s->pages) + 63) / 64) * sizeof(u64));
+    }
+    s->pages = pages;
+    s->released = pages;
+    s->pos = a->pos;
+    return s;
+}
+
+void Arena_restore(Arena *a) {
+    ArenaSnapshot *s = a->snapshot;
+    if (!s) {
+        return;
+    }
+    u64 page_size = s->page_size;
+    u64 end = s->pages * page_size;
+    u64 real_pos = sizeof(Arena) + s->pos;
+
+    /* Released pages are copied back whole, so commit them again */
+    if (a->commit_pos < end) {
+        _Arena_commit(a, a->commit_pos, end);
+        a->commit_pos = end;
+    }
+
+    /* The header is restored too, but only pos should go back, the rest describes the
+       memory as it is now */
+    Arena live = *a;
+    LCF_MEMORY_UNPOISON(Arena_mem_start(a), s->pos);
+    s->copied = 0;
+    for (u64 page = 0; page < s->pages; page++) {
+        if (!s->watching || page >= s->released || SNAPSHOT_DIRTY(s, page)) {
+            _ArenaSnapshot_copy((u8*) a, s->shadow, page, page_size, real_pos);
+            s->copied++;
+        }
+    }
+    *a = live;
+    a->pos = s->pos;
+    LCF_MEMORY_POISON(Arena_mem_start(a) + a->pos, a->commit_pos - real_pos);
+
+    if (s->watching) {
+        if (s->released < s->pages) {
+            LCF_MEMORY_watch_writes(a, end, page_size, s->dirty);
+        }
+        for (u64 page = s->released; page < s->pages; page++) {
+            s->dirty[page >> 6] |= 1ull << (page & 63);
+        }
+        _ArenaSnapshot_protect(a, 0, s->pages, 1, 0);
+        memset(s->dirty, 0, ((s->pages + 63) / 64) * sizeof(u64));
+    }
+    s->released = s->pages;
+}
+
+void Arena_snapshot_end(Arena *a) {
+    ArenaSnapshot *s = a->snapshot;
+    if (!s) {
+        return;
+    }
+    if (s->watching) {
+        _ArenaSnapshot_protect(a, 0, s->released, 0, 1);
+        LCF_MEMORY_watch_writes(a, 0, s->page_size, s->dirty);
+    }
+    a->snapshot = 0;
+    LCF_MEMORY_free(s->shadow, a->size);
+    LCF_MEMORY_free(s, s->size);
+}
+#undef SNAPSHOT_DIRTY
+
+void* Arena_root(Arena *a, u64 size) {
+    if (Arena_pos(a) == 0) {
+        return (Arena_take_zero)(a, size);
+    }
+    return Arena_mem_start(a) + next_alignment(Arena_mem_start(a), 0, a->alignment);
 }
 
 void Arena_resetp(Arena *a, void* previous_alloc) {
     if (previous_alloc) {
-        ASSERT((u8*)(previous_alloc) - Arena_mem_start(a) > 0);
-        u64 pos = ((u8*)(previous_alloc) - Arena_mem_start(a));
+        /* Find the block the allocation came from */
+        Arena *block = a->current;
+        while (block->prev && !((u8*)(previous_alloc) > (u8*)(block) && (u8*)(previous_alloc) < (u8*)(block) + block->size)) {
+            block = block->prev;
+        }
+        ASSERT((u8*)(previous_alloc) - Arena_mem_start(block) >= 0);
+        u64 pos = block->base_pos + ((u8*)(previous_alloc) - Arena_mem_start(block));
         Arena_reset(a, pos);
     }
 }
@@ -123,7 +645,7 @@ void Arena_resetp(Arena *a, void* previous_alloc) {
 ArenaSession ArenaSession_begin(Arena *a) {
     ArenaSession s;
     s.arena = a;
-    s.save_point = a->pos;
+    s.save_point = Arena_pos(a);
     return s;
 }
 
@@ -137,15 +659,22 @@ void ArenaSession_end(ArenaSession s) {
 #define LCF_SCRATCH_COUNT 2
 per_thread Arena* _arena_scratch_pool[LCF_SCRATCH_COUNT];
 void Arena_thread_init_scratch() {
-    Arena params;
+    Arena params = ZERO_STRUCT;
     params.size = LCF_MEMORY_ARENA_SIZE;
     params.alignment = (u32) LCF_MEMORY_ALIGNMENT;
     params.commit_size = (u32) LCF_MEMORY_COMMIT_SIZE;
     params.commit_pos = 0;
+    params.flags = LCF_MEMORY_SCRATCH_FLAGS;
+    s32 node = LCF_MEMORY_current_node();
+    if (node >= 0) {
+        params.flags |= ARENA_NUMA;
+        params.numa_node = (u32) node;
+    }
     
     if (_arena_scratch_pool[0] == 0) {
         for (s32 i = 0; i < LCF_SCRATCH_COUNT; i++) {
             _arena_scratch_pool[i] = Arena_create_custom(params);
+            Arena_set_name(_arena_scratch_pool[i], "scratch");
         }
     }
 }
@@ -177,4 +706,517 @@ ArenaSession Scratch_session_custom(Arena** conflicts, s32 n) {
     return out;
 }
 
+/* Pools */
+Pool* Pool_create(Arena *a, u64 slot_size, u32 alignment) {
+    alignment = MAX(alignment, (u32) sizeof(PoolSlot*));
+    
+    Pool *p = Arena_take_struct_zero(a, Pool);
+    p->arena = a;
+    p->alignment = alignment;
+    p->slot_size = next_alignment(0, MAX(slot_size, sizeof(PoolSlot)), alignment);
+    p->base_pos = Arena_pos(a);
+    return p;
+}
+
+/* Carves n contiguous slots from the arena and links them into a list */
+internal PoolSlot* _Pool_carve(Pool *p, u32 n) {
+    u8 *mem = (u8*) (Arena_take_custom)(p->arena, p->slot_size*n, p->alignment);
+    for (u32 i = 0; i < n-1; i++) {
+        ((PoolSlot*)(mem + i*p->slot_size))->next = (PoolSlot*)(mem + (i+1)*p->slot_size);
+    }
+    ((PoolSlot*)(mem + (n-1)*p->slot_size))->next = 0;
+    p->slots += n;
+    return (PoolSlot*) mem;
+}
+
+void* (Pool_take)(Pool *p) {
+    PoolSlot *s = p->free;
+    if (s) {
+        p->free = s->next;
+    } else {
+        s = _Pool_carve(p, 1);
+    }
+    return s;
+}
+
+void* (Pool_take_zero)(Pool *p) {
+    void *s = (Pool_take)(p);
+    memset(s, 0, p->slot_size);
+    return s;
+}
+
+void Pool_free(Pool *p, void *slot) {
+    if (slot) {
+        if (LCF_MEMORY_DEBUG_CLEAR) {
+            memset(slot, LCF_MEMORY_ARENA_CLEAR, p->slot_size);
+        }
+        PoolSlot *s = (PoolSlot*) slot;
+        s->next = p->free;
+        p->free = s;
+    }
+}
+
+void Pool_reset(Pool *p) {
+    Arena_reset(p->arena, p->base_pos);
+    p->free = 0;
+    p->slots = 0;
+}
+
+internal void _Pool_lock(Pool *p) {
+    while (!ATOMIC_CAS_U64(&p->lock, 0, 1)) {
+        CPU_PAUSE();
+    }
+}
+
+internal void _Pool_unlock(Pool *p) {
+    ASSERTM(ATOMIC_LOAD_U64(&p->lock) == 1, "Pool unlocked twice.");
+    ATOMIC_STORE_U64(&p->lock, 0);
+}
+
+PoolCache PoolCache_begin(Pool *p) {
+    PoolCache c = ZERO_STRUCT;
+    c.pool = p;
+    return c;
+}
+
+void PoolCache_end(PoolCache *c) {
+    if (c->free) {
+        PoolSlot *last = c->free;
+        while (last->next) {
+            last = last->next;
+        }
+        _Pool_lock(c->pool);
+        last->next = c->pool->free;
+        c->pool->free = c->free;
+        _Pool_unlock(c->pool);
+    }
+    c->free = 0;
+    c->count = 0;
+}
+
+void* (PoolCache_take)(PoolCache *c) {
+    if (!c->free) {
+        /* Refill half the cache, from the free list first then the arena */
+        u32 n = LCF_MEMORY_POOL_CACHE_COUNT/2;
+        u32 got = 0;
+        _Pool_lock(c->pool);
+        Pool *p = c->pool;
+        while (p->free && got < n) {
+            PoolSlot *s = p->free;
+            p->free = s->next;
+            s->next = c->free;
+            c->free = s;
+            got++;
+        }
+        if (got < n) {
+            PoolSlot *carved = _Pool_carve(p, n - got);
+            PoolSlot *last = carved;
+            while (last->next) {
+                last = last->next;
+            }
+            last->next = c->free;
+            c->free = carved;
+        }
+        _Pool_unlock(p);
+        c->count = n;
+    }
+    PoolSlot *s = c->free;
+    c->free = s->next;
+    c->count--;
+    return s;
+}
+
+void PoolCache_free(PoolCache *c, void *slot) {
+    if (slot) {
+        if (LCF_MEMORY_DEBUG_CLEAR) {
+            memset(slot, LCF_MEMORY_ARENA_CLEAR, c->pool->slot_size);
+        }
+        PoolSlot *s = (PoolSlot*) slot;
+        s->next = c->free;
+        c->free = s;
+        c->count++;
+
+        if (c->count >= LCF_MEMORY_POOL_CACHE_COUNT) {
+            /* Give half back to the Pool */
+            PoolSlot *first = c->free;
+            PoolSlot *last = first;
+            for (u32 i = 1; i < LCF_MEMORY_POOL_CACHE_COUNT/2; i++) {
+                last = last->next;
+            }
+            c->free = last->next;
+            c->count -= LCF_MEMORY_POOL_CACHE_COUNT/2;
+            
+            _Pool_lock(c->pool);
+            last->next = c->pool->free;
+            c->pool->free = first;
+            _Pool_unlock(c->pool);
+        }
+    }
+}
+
+/* Virtual Arrays */
+VArray VArray_create_custom(u64 elem_size, u64 max_count) {
+    VArray v = ZERO_STRUCT;
+    v.elem_size = elem_size;
+    v.commit_size = (u32) LCF_MEMORY_COMMIT_SIZE;
+    v.size = next_alignment(0, elem_size*max_count, v.commit_size);
+    v.data = (u8*) LCF_MEMORY_reserve(v.size);
+    ASSERT(v.data);
+    return v;
+}
+
+void VArray_destroy(VArray *v) {
+    LCF_MEMORY_free(v->data, v->size);
+    *v = (VArray) ZERO_STRUCT;
+}
+
+/* Makes room for count more elements and returns the first one */
+internal u8* _VArray_extend(VArray *v, u64 count) {
+    u64 pos = v->len*v->elem_size;
+    u64 new_pos = pos + count*v->elem_size;
+    if (new_pos > v->size) {
+        return 0; // VArray is full
+    }
+
+    if (new_pos > v->commit_pos) {
+        u64 step = MIN(MAX(v->commit_pos, v->commit_size), MAX(LCF_MEMORY_COMMIT_GROW_MAX, v->commit_size));
+        u64 target = MAX(new_pos, v->commit_pos + step);
+        target = MIN(next_alignment(0, target, v->commit_size), v->size);
+        if (!LCF_MEMORY_commit(v->data + v->commit_pos, target - v->commit_pos)) {
+            ASSERT(0); // VArray out of memory!
+            return 0;
+        }
+        v->commit_pos = target;
+    }
+
+    v->len += count;
+    return v->data + pos;
+}
+
+void* VArray_push(VArray *v) {
+    u8 *elem = _VArray_extend(v, 1);
+    if (elem) {
+        memset(elem, 0, v->elem_size);
+    }
+    return elem;
+}
+
+void* VArray_append(VArray *v, void *elems, u64 count) {
+    u8 *first = _VArray_extend(v, count);
+    if (first) {
+        memcpy(first, elems, count*v->elem_size);
+    }
+    return first;
+}
+
+void* VArray_pop(VArray *v) {
+    ASSERT(v->len > 0);
+    v->len--;
+    return v->data + v->len*v->elem_size;
+}
+
+void VArray_reset(VArray *v, u64 len) {
+    ASSERT(len <= v->len);
+    v->len = len;
+}
+
+/* Frame Arenas */
+Frames Frames_create_custom(u32 count, Arena params) {
+    ASSERTM(count > 0 && count <= LCF_MEMORY_FRAMES_MAX, "Too many frames, raise LCF_MEMORY_FRAMES_MAX.");
+    Frames f = ZERO_STRUCT;
+    f.count = count;
+    for (u32 i = 0; i < count; i++) {
+        f.arena[i] = Arena_create_custom(params);
+        Arena_set_name(f.arena[i], "frame");
+    }
+    return f;
+}
+
+void Frames_destroy(Frames *f) {
+    for (u32 i = 0; i < f->count; i++) {
+        Arena_destroy(f->arena[i]);
+    }
+    *f = (Frames) ZERO_STRUCT;
+}
+
+Arena* Frame_begin(Frames *f) {
+    u32 current = (u32)(f->frame % f->count);
+    u64 peak = Arena_peak(f->arena[current]);
+    f->peak[current] = peak;
+    f->last_peak = peak;
+    f->max_peak = MAX(f->max_peak, peak);
+
+    f->frame++;
+    Arena *a = f->arena[f->frame % f->count];
+    Arena_reset(a, 0);
+    a->peak_pos = 0;
+    return a;
+}
+
+Arena* Frame_arena(Frames *f, u32 frames_ago) {
+    ASSERT(frames_ago < f->count);
+    return f->arena[(f->frame + f->count - frames_ago) % f->count];
+}
+
+/* Lock-free Stack and Queue */
+#define ATOMIC_PTR_MASK (((u64) 1 << 48) - 1)
+#define ATOMIC_NEXT(node, offset) ((u64*) (B_PTR(node) + (offset)))
+
+void _AtomicStack_push(AtomicStack *s, void *node, u64 next_offset) {
+    ASSERTM(((upr) node & ~ATOMIC_PTR_MASK) == 0, "Pointer doesn't fit in 48 bits.");
+    u64 old, new_head;
+    do {
+        old = ATOMIC_LOAD_U64(&s->head);
+        ATOMIC_STORE_U64(ATOMIC_NEXT(node, next_offset), old & ATOMIC_PTR_MASK);
+        new_head = (((old >> 48) + 1) << 48) | (upr) node;
+    } while (!ATOMIC_CAS_U64(&s->head, old, new_head));
+}
+
+void* _AtomicStack_pop(AtomicStack *s, u64 next_offset) {
+    u64 old, node, new_head;
+    do {
+        old = ATOMIC_LOAD_U64(&s->head);
+        node = old & ATOMIC_PTR_MASK;
+        if (!node) {
+            return 0;
+        }
+        u64 next = ATOMIC_LOAD_U64(ATOMIC_NEXT(node, next_offset));
+        new_head = (((old >> 48) + 1) << 48) | next;
+    } while (!ATOMIC_CAS_U64(&s->head, old, new_head));
+    return (void*) (upr) node;
+}
+
+/* The stub is a fake node placed so that its next field is q->stub */
+internal u8* _AtomicQueue_stub(AtomicQueue *q, u64 next_offset) {
+    return B_PTR(&q->stub) - next_offset;
+}
+
+void _AtomicQueue_push(AtomicQueue *q, void *node, u64 next_offset) {
+    ATOMIC_STORE_U64(ATOMIC_NEXT(node, next_offset), 0);
+    u64 prev = ATOMIC_EXCHANGE_U64(&q->head, (upr) node);
+    if (!prev) {
+        prev = (upr) _AtomicQueue_stub(q, next_offset);
+    }
+    ATOMIC_STORE_U64(ATOMIC_NEXT(prev, next_offset), (upr) node);
+}
+
+void* _AtomicQueue_pop(AtomicQueue *q, u64 next_offset) {
+    u8 *stub = _AtomicQueue_stub(q, next_offset);
+    u8 *tail = (q->tail)? (u8*) q->tail : stub;
+    u8 *next = (u8*) (upr) ATOMIC_LOAD_U64(ATOMIC_NEXT(tail, next_offset));
+    if (tail == stub) {
+        if (!next) {
+            return 0;
+        }
+        q->tail = tail = next;
+        next = (u8*) (upr) ATOMIC_LOAD_U64(ATOMIC_NEXT(next, next_offset));
+    }
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+
+    /* tail is the last node, unless a push is half done */
+    if (tail != (u8*) (upr) ATOMIC_LOAD_U64(&q->head)) {
+        return 0;
+    }
+    _AtomicQueue_push(q, stub, next_offset);
+    next = (u8*) (upr) ATOMIC_LOAD_U64(ATOMIC_NEXT(tail, next_offset));
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+    return 0;
+}
+
+#undef ATOMIC_PTR_MASK
+#undef ATOMIC_NEXT
+
+/* Instrumentation */
+#if LCF_MEMORY_INSTRUMENT
+per_thread char *_arena_site_file;
+per_thread u32 _arena_site_line;
+
+global ArenaStats *_arena_stats_first;
+global u64 _arena_stats_lock;
+
+internal void _ArenaStats_lock(void) {
+    while (!ATOMIC_CAS_U64(&_arena_stats_lock, 0, 1)) {
+        CPU_PAUSE();
+    }
+}
+
+internal void _ArenaStats_unlock(void) {
+    ASSERTM(ATOMIC_LOAD_U64(&_arena_stats_lock) == 1, "Arena registry unlocked twice.");
+    ATOMIC_STORE_U64(&_arena_stats_lock, 0);
+}
+
+internal void _ArenaStats_register(Arena *a) {
+    /* Stats come straight from the backing memory so they don't show up in any arena */
+    ArenaStats *s = (ArenaStats*) LCF_MEMORY_reserve(sizeof(ArenaStats));
+    LCF_MEMORY_commit(s, sizeof(ArenaStats));
+    memset(s, 0, sizeof(ArenaStats));
+    s->arena = a;
+    s->file = _arena_site_file? _arena_site_file : "?";
+    s->line = _arena_site_line;
+    _arena_site_file = 0;
+    a->stats = s;
+
+    _ArenaStats_lock();
+    s->next = _arena_stats_first;
+    if (s->next) {
+        s->next->prev = s;
+    }
+    _arena_stats_first = s;
+    _ArenaStats_unlock();
+}
+
+internal void _ArenaStats_unregister(Arena *a) {
+    ArenaStats *s = a->stats;
+    _ArenaStats_lock();
+    if (s->prev) {
+        s->prev->next = s->next;
+    } else {
+        _arena_stats_first = s->next;
+    }
+    if (s->next) {
+        s->next->prev = s->prev;
+    }
+    _ArenaStats_unlock();
+    LCF_MEMORY_free(s, sizeof(ArenaStats));
+}
+
+internal void _ArenaStats_max(u64 *peak, u64 v) {
+    u64 old = ATOMIC_LOAD_U64(peak);
+    while (v > old && !ATOMIC_CAS_U64(peak, old, v)) {
+        old = ATOMIC_LOAD_U64(peak);
+    }
+}
+
+internal void _ArenaStats_take(Arena *a, u64 size, u64 pos) {
+    ArenaStats *s = a->stats;
+    char *file = _arena_site_file? _arena_site_file : "?";
+    u32 line = _arena_site_line;
+    _arena_site_file = 0;
+
+    ATOMIC_ADD_U64(&s->takes, 1);
+    ATOMIC_ADD_U64(&s->bytes, size);
+    _ArenaStats_max(&s->peak_pos, pos);
+
+    /* Open addressing on the site, slots are claimed with a CAS so concurrent takes are fine */
+    u64 key = (((u64)(upr) file) ^ ((u64) line << 40)) * 0x9E3779B97F4A7C15ull;
+    key = key? key : 1;
+    u32 mask = LCF_MEMORY_INSTRUMENT_SITES - 1;
+    for (u32 i = 0; i <= mask; i++) {
+        ArenaSite *site = s->site + (((key >> 32) + i) & mask);
+        u64 site_key = ATOMIC_LOAD_U64(&site->key);
+        if (site_key == 0 && ATOMIC_CAS_U64(&site->key, 0, key)) {
+            site->file = file;
+            site->line = line;
+            site_key = key;
+        }
+        if (site_key == key || ATOMIC_LOAD_U64(&site->key) == key) {
+            ATOMIC_ADD_U64(&site->takes, 1);
+            ATOMIC_ADD_U64(&site->bytes, size);
+            break;
+        }
+    }
+}
+
+internal void _ArenaStats_commit(Arena *a, u64 commit_pos) {
+    _ArenaStats_max(&a->stats->peak_commit_pos, a->base_pos + commit_pos);
+}
+
+ArenaStats* ArenaStats_first(void) {
+    return _arena_stats_first;
+}
+
+u64 ArenaStats_commits(ArenaStats *s) {
+    u64 result = 0;
+    for (Arena *block = s->arena->current; block; block = block->prev) {
+        result += block->commits;
+    }
+    for (Arena *block = s->arena->free; block; block = block->prev) {
+        result += block->commits;
+    }
+    return result;
+}
+
+u64 ArenaStats_decommits(ArenaStats *s) {
+    u64 result = 0;
+    for (Arena *block = s->arena->current; block; block = block->prev) {
+        result += block->decommits;
+    }
+    for (Arena *block = s->arena->free; block; block = block->prev) {
+        result += block->decommits;
+    }
+    return result;
+}
+
+#define ARENA_NUMA_SAMPLES 64
+
+/* Samples pages in use across the blocks, counting those resident and those on numa_node */
+internal void _ArenaStats_numa(Arena *a, u64 *on_node, u64 *resident) {
+    void *pages[ARENA_NUMA_SAMPLES];
+    s32 nodes[ARENA_NUMA_SAMPLES];
+    *on_node = *resident = 0;
+    for (Arena *block = a->current; block; block = block->prev) {
+        u64 page_size = LCF_MEMORY_COMMIT_SIZE;
+        u64 used = (sizeof(Arena) + block->pos + page_size - 1) / page_size;
+        u64 count = MIN(used, ARENA_NUMA_SAMPLES);
+        for (u64 i = 0; i < count; i++) {
+            pages[i] = (u8*) block + (i * used / count) * page_size;
+        }
+        if (!LCF_MEMORY_page_nodes(pages, count, nodes)) {
+            return;
+        }
+        for (u64 i = 0; i < count; i++) {
+            *resident += nodes[i] >= 0;
+            *on_node += nodes[i] == (s32) a->numa_node;
+        }
+    }
+}
+
+StrList ArenaStats_report(Arena *out) {
+    StrList report = ZERO_STRUCT;
+    _ArenaStats_lock();
+    for (ArenaStats *s = _arena_stats_first; s; s = s->next) {
+        str numa = str_EMPTY;
+        if (s->arena->flags & ARENA_NUMA) {
+            u64 on_node, resident;
+            _ArenaStats_numa(s->arena, &on_node, &resident);
+            numa = strf(out, ", node %u (%llu/%llu sampled pages local)", s->arena->numa_node, on_node, resident);
+        }
+        StrList_push(out, &report, strf(out,
+            "%s (%s:%u): pos %llu, peak %llu, peak commit %llu, takes %llu, bytes %llu, commits %llu, decommits %llu%.*s\n",
+            s->name? s->name : "arena", s->file, s->line, Arena_pos(s->arena), s->peak_pos,
+            s->peak_commit_pos, s->takes, s->bytes, ArenaStats_commits(s), ArenaStats_decommits(s),
+            str_PRINTF_ARGS(numa)));
+
+        /* Selection sort by bytes, the site table is small */
+        ArenaSite *sorted[LCF_MEMORY_INSTRUMENT_SITES];
+        u32 n = 0;
+        for (u32 i = 0; i < LCF_MEMORY_INSTRUMENT_SITES; i++) {
+            if (s->site[i].key) {
+                sorted[n++] = s->site + i;
+            }
+        }
+        for (u32 i = 0; i < n; i++) {
+            u32 max = i;
+            for (u32 j = i+1; j < n; j++) {
+                if (sorted[j]->bytes > sorted[max]->bytes) {
+                    max = j;
+                }
+            }
+            SWAP(ArenaSite*, sorted[i], sorted[max]);
+            StrList_push(out, &report, strf(out, "    %s:%u: takes %llu, bytes %llu\n",
+                sorted[i]->file, sorted[i]->line, sorted[i]->takes, sorted[i]->bytes));
+        }
+    }
+    _ArenaStats_unlock();
+    return report;
+}
+#undef ARENA_NUMA_SAMPLES
+#endif
+
 #undef B_PTR
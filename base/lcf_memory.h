@@ -44,30 +44,243 @@
  #define LCF_MEMORY_free _lcf_memory_stdlib_free
 #endif
 
+/* Optional backing memory functions, the defaults report the feature as unavailable and
+   Arenas fall back to the functions above.
+   reserve_large: reserve memory backed by LCF_MEMORY_LARGE_PAGE_SIZE pages, aligned to that
+       size, or return 0 if large pages are unavailable.
+   prefault: fault in already committed memory so later writes don't page fault.
+   protect: make committed memory inaccessible without releasing it, committing it again makes
+       it accessible. Returns 0 if unsupported.
+   map_file: map size bytes of the file at path read/write and shared, creating or growing the
+       file as needed. Returns 0 if unsupported or the file can't be opened.
+   unmap_file: unmap memory from map_file, and cut the file down to file_size.
+   map_ring: reserve 2*size bytes where the second half maps the same memory as the first, so
+       reads and writes can run past the end and land at the start. size must be a multiple of
+       KB(64). Returns 0 if unsupported.
+   unmap_ring: release memory from map_ring.
+   watch_writes: track writes to memory in page_size pages. While a page is write protected
+       with protect_writes, the first write to it sets its bit in dirty and makes it writable
+       again instead of faulting. Calling it again for the same memory updates the size, a size
+       of 0 stops tracking. Returns 0 if unsupported.
+   protect_writes: make memory read only, or read/write again if writable.
+   bind_node: make reserved memory prefer physical pages from NUMA node when it is first
+       touched. Returns 0 if unsupported or the machine has a single node.
+   current_node: NUMA node of the calling thread, or -1 if unknown or there is a single node.
+   page_nodes: set nodes[i] to the NUMA node holding pages[i], or -1 if it isn't resident.
+       Returns 0 if unsupported.
+ */
+#define LCF_MEMORY_RESERVE_LARGE_MEMORY(name) void* name(upr size)
+#define LCF_MEMORY_PREFAULT_MEMORY(name) void name(void* memory, upr size)
+#define LCF_MEMORY_PROTECT_MEMORY(name) s32 name(void* memory, upr size)
+#define LCF_MEMORY_MAP_FILE(name) void* name(char *path, upr size)
+#define LCF_MEMORY_UNMAP_FILE(name) void name(char *path, void* memory, upr size, upr file_size)
+#define LCF_MEMORY_MAP_RING(name) void* name(upr size)
+#define LCF_MEMORY_UNMAP_RING(name) void name(void* memory, upr size)
+#define LCF_MEMORY_WATCH_WRITES(name) s32 name(void* memory, upr size, upr page_size, u64 *dirty)
+#define LCF_MEMORY_PROTECT_WRITES(name) void name(void* memory, upr size, s32 writable)
+#define LCF_MEMORY_BIND_NODE(name) s32 name(void* memory, upr size, u32 node)
+#define LCF_MEMORY_CURRENT_NODE(name) s32 name(void)
+#define LCF_MEMORY_PAGE_NODES(name) s32 name(void** pages, u64 count, s32* nodes)
+
+#if !defined(LCF_MEMORY_reserve_large)
+ internal LCF_MEMORY_RESERVE_LARGE_MEMORY(_lcf_memory_no_reserve_large) {
+     (void) size;
+     return 0;
+ }
+ #define LCF_MEMORY_reserve_large _lcf_memory_no_reserve_large
+#endif
+#if !defined(LCF_MEMORY_prefault)
+ internal LCF_MEMORY_PREFAULT_MEMORY(_lcf_memory_no_prefault) {
+     (void) memory;
+     (void) size;
+ }
+ #define LCF_MEMORY_prefault _lcf_memory_no_prefault
+#endif
+#if !defined(LCF_MEMORY_protect)
+ internal LCF_MEMORY_PROTECT_MEMORY(_lcf_memory_no_protect) {
+     (void) memory;
+     (void) size;
+     return 0;
+ }
+ #define LCF_MEMORY_protect _lcf_memory_no_protect
+#endif
+#if !defined(LCF_MEMORY_map_file)
+ internal LCF_MEMORY_MAP_FILE(_lcf_memory_no_map_file) {
+     (void) path;
+     (void) size;
+     return 0;
+ }
+ internal LCF_MEMORY_UNMAP_FILE(_lcf_memory_no_unmap_file) {
+     (void) path;
+     (void) memory;
+     (void) size;
+     (void) file_size;
+ }
+ #define LCF_MEMORY_map_file _lcf_memory_no_map_file
+ #define LCF_MEMORY_unmap_file _lcf_memory_no_unmap_file
+#endif
+#if !defined(LCF_MEMORY_map_ring)
+ internal LCF_MEMORY_MAP_RING(_lcf_memory_no_map_ring) {
+     (void) size;
+     return 0;
+ }
+ internal LCF_MEMORY_UNMAP_RING(_lcf_memory_no_unmap_ring) {
+     (void) memory;
+     (void) size;
+ }
+ #define LCF_MEMORY_map_ring _lcf_memory_no_map_ring
+ #define LCF_MEMORY_unmap_ring _lcf_memory_no_unmap_ring
+#endif
+#if !defined(LCF_MEMORY_watch_writes)
+ internal LCF_MEMORY_WATCH_WRITES(_lcf_memory_no_watch_writes) {
+     (void) memory;
+     (void) size;
+     (void) page_size;
+     (void) dirty;
+     return 0;
+ }
+ internal LCF_MEMORY_PROTECT_WRITES(_lcf_memory_no_protect_writes) {
+     (void) memory;
+     (void) size;
+     (void) writable;
+ }
+ #define LCF_MEMORY_watch_writes _lcf_memory_no_watch_writes
+ #define LCF_MEMORY_protect_writes _lcf_memory_no_protect_writes
+#endif
+#if !defined(LCF_MEMORY_bind_node)
+ internal LCF_MEMORY_BIND_NODE(_lcf_memory_no_bind_node) {
+     (void) memory;
+     (void) size;
+     (void) node;
+     return 0;
+ }
+ internal LCF_MEMORY_CURRENT_NODE(_lcf_memory_no_current_node) {
+     return -1;
+ }
+ internal LCF_MEMORY_PAGE_NODES(_lcf_memory_no_page_nodes) {
+     (void) pages;
+     (void) count;
+     (void) nodes;
+     return 0;
+ }
+ #define LCF_MEMORY_bind_node _lcf_memory_no_bind_node
+ #define LCF_MEMORY_current_node _lcf_memory_no_current_node
+ #define LCF_MEMORY_page_nodes _lcf_memory_no_page_nodes
+#endif
+#if !defined(LCF_MEMORY_LARGE_PAGE_SIZE)
+ #define LCF_MEMORY_LARGE_PAGE_SIZE MB(2)
+#endif
+
 #if !defined(LCF_MEMORY_ARENA_SIZE)
  #define LCF_MEMORY_ARENA_SIZE GB(1)
 #endif
 #if !defined(LCF_MEMORY_COMMIT_SIZE)
  #define LCF_MEMORY_COMMIT_SIZE KB(4)
 #endif
+/* Largest step ARENA_COMMIT_GROW will commit at once */
+#if !defined(LCF_MEMORY_COMMIT_GROW_MAX)
+ #define LCF_MEMORY_COMMIT_GROW_MAX MB(64)
+#endif
 #if !defined(LCF_MEMORY_ALIGNMENT)
  #define LCF_MEMORY_ALIGNMENT (sizeof(void*))
 #endif
 
 /** Macro to specify whether memory should be cleared. For example, when enabled Arena_reset will 
     clear memory beyond the Arena->pos, to try and force a crash if anyone is still holding on to it.
+    Set to LCF_MEMORY_DEBUG_PROTECT to instead protect the freed whole pages with LCF_MEMORY_protect,
+    only clearing the partial page at the start. Much cheaper for large resets, and any access
+    crashes right away instead of reading garbage.
  **/
+#define LCF_MEMORY_DEBUG_PROTECT 2
 #if !defined(LCF_MEMORY_DEBUG_CLEAR)
 #define LCF_MEMORY_DEBUG_CLEAR 1
+#endif
+#if !defined(LCF_MEMORY_ARENA_CLEAR)
 #define LCF_MEMORY_ARENA_CLEAR 0xCF
 #endif
 
+/* When built with -fsanitize=address, memory taken from Arenas is unpoisoned and reset memory
+   is poisoned again, so ASan reports use after reset and overflows into unused Arena memory. */
+#if defined(__has_feature)
+ #if __has_feature(address_sanitizer)
+  #define LCF_MEMORY_ASAN 1
+ #endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) && !defined(LCF_MEMORY_ASAN)
+ #define LCF_MEMORY_ASAN 1
+#endif
+#if LCF_MEMORY_ASAN
+ #include <sanitizer/asan_interface.h>
+ #define LCF_MEMORY_POISON(p, size) ASAN_POISON_MEMORY_REGION(p, size)
+ #define LCF_MEMORY_UNPOISON(p, size) ASAN_UNPOISON_MEMORY_REGION(p, size)
+#else
+ #define LCF_MEMORY_POISON(p, size) ((void)(p), (void)(size))
+ #define LCF_MEMORY_UNPOISON(p, size) ((void)(p), (void)(size))
+#endif
+
+/** Macro to enable Arena instrumentation, see ArenaStats below. When 0 all of it compiles away. **/
+#if !defined(LCF_MEMORY_INSTRUMENT)
+#define LCF_MEMORY_INSTRUMENT 0
+#endif
+
+/** Macro to set the flags used for the per-thread scratch arenas, eg ARENA_CHAINED lets a
+    small LCF_MEMORY_ARENA_SIZE be used without scratch memory running out on rare huge loads.
+    Scratch arenas also get ARENA_NUMA for the node of the thread that creates them, on machines
+    with more than one node.
+ **/
+#if !defined(LCF_MEMORY_SCRATCH_FLAGS)
+#define LCF_MEMORY_SCRATCH_FLAGS 0
+#endif
+
+enum ArenaFlags {
+    ARENA_CHAINED = FLAG(0), /* When the reserve runs out, link in a new block instead of failing */
+    ARENA_LARGE_PAGES = FLAG(1), /* Back with large pages if available, cleared on fallback */
+
+    /* Commit policies, the default commits the next commit_size aligned pos when needed */
+    ARENA_COMMIT_GROW = FLAG(2), /* Double the commit step every commit, up to LCF_MEMORY_COMMIT_GROW_MAX */
+    ARENA_COMMIT_ALL = FLAG(3), /* Commit the whole reserve up front and rely on overcommit */
+    ARENA_COMMIT_PREFAULT = FLAG(4), /* Fault in pages as they are committed */
+
+    ARENA_FILE = FLAG(5), /* Map the file at Arena.file instead of reserving, see File Arenas */
+    ARENA_NUMA = FLAG(6), /* Place pages on NUMA node numa_node, cleared if that isn't possible */
+};
+
 struct Arena {
     u64 pos;
     u64 size;
     u64 commit_pos; 
     u32 commit_size;
     u32 alignment;
+    u32 flags;
+    char *file; /* Path for ARENA_FILE, must stay valid until Arena_destroy */
+    u32 numa_node; /* For ARENA_NUMA */
+    u64 commits; /* Number of commit calls made for this block */
+    u64 decommits;
+    u64 protect_end; /* With LCF_MEMORY_DEBUG_PROTECT, [commit_pos, protect_end) is committed but protected */
+
+    /* Automatic decommit: once the arena is reset decommit_resets times in a row without
+       having gone past decommit_pos, memory committed past decommit_pos is released.
+       A decommit_pos of 0 disables it. */
+    u64 decommit_pos;
+    u32 decommit_resets;
+    u32 resets_below;
+
+    u64 peak_pos; /* Highest pos a reset or shrink has taken back from, see Arena_peak */
+
+    /* Chained arenas are a list of blocks, each one an Arena itself. base_pos is where the
+       block starts in the position space of the whole arena. Only the first block (the one
+       handed out by Arena_create) uses current and free, free being a cache of released
+       blocks linked through prev. For an unchained arena current is always the arena. */
+    u64 base_pos;
+    struct Arena *current;
+    struct Arena *prev;
+    struct Arena *free;
+
+    struct ArenaSnapshot *snapshot; /* See Snapshots */
+
+    #if LCF_MEMORY_INSTRUMENT
+    struct ArenaStats *stats; /* Shared by all blocks */
+    #endif
 };
 typedef struct Arena Arena;
 
@@ -96,10 +309,118 @@ inline void* Arena_take_zero_custom(Arena *a, u64 size, u32 alignment);
 #define Arena_take_struct_zero(a, type) ((type*) Arena_take_zero(a, sizeof(type)))
 #define Arena_mem_start(a) (((u8 *)a) + sizeof(Arena))
 
+/* File Arenas
+   With ARENA_FILE the Arena is a shared mapping of a file, so everything taken from it is saved
+   to the file, and creating the Arena again from the same file maps it all back in with pos
+   where it was left. The whole size is mapped up front and is never decommitted, so prefer a
+   modest size. Arena_destroy cuts the file down to what was used. File arenas can't be chained.
+   Arena_create returns 0 if the file can't be mapped.
+
+   Anything stored in the arena has to survive being mapped at another address, so link it with
+   RelPtr instead of plain pointers. Arena_root gives the first allocation of the arena, taking
+   it (zeroed) if the arena is new, which makes it a natural place for the top level struct.
+ */
+void* Arena_root(Arena *a, u64 size);
+#define Arena_root_struct(a, type) ((type*) Arena_root(a, sizeof(type)))
+
+/* Relative Pointers
+   Stores the distance from its own address to the target, so it stays valid when the memory
+   holding both moves. 0 is null, so a RelPtr can't point at itself. */
+struct RelPtr {
+    s64 offset;
+};
+typedef struct RelPtr RelPtr;
+
+static inline void* RelPtr_get(RelPtr *r) {
+    return (r->offset)? (u8*) r + r->offset : 0;
+}
+
+static inline void RelPtr_set(RelPtr *r, void *ptr) {
+    r->offset = (ptr)? (u8*) ptr - (u8*) r : 0;
+}
+#define RelPtr_get_as(r, type) ((type*) RelPtr_get(r))
+
+/* Resize an allocation. If ptr is the last thing taken from the Arena this just moves pos,
+   so growing a buffer costs no copy. Otherwise Arena_grow takes new memory with the default
+   alignment and copies old_size bytes over, and Arena_shrink does nothing.
+   Not for use with Arena_take_atomic. */
+void* Arena_grow(Arena *a, void *ptr, u64 old_size, u64 new_size);
+void Arena_shrink(Arena *a, void *ptr, u64 old_size, u64 new_size);
+#define Arena_grow_array(a, ptr, type, old_count, new_count) ((type*) Arena_grow(a, ptr, sizeof(type)*(old_count), sizeof(type)*(new_count)))
+
+/* Position of the Arena, for use with Arena_reset. Prefer this over reading a->pos, which is
+   only the position within the current block for chained arenas. */
+u64 Arena_pos(Arena *a);
+u64 Arena_peak(Arena *a); /* Highest Arena_pos so far, clear a->peak_pos to start over */
+
+/* Concurrent Arenas
+   Arena_take_atomic can be called from many threads on the same Arena. pos is bumped with a
+   fetch-add and commit_pos is only ever moved forward with a CAS. Not for chained arenas, and
+   not to be mixed with the single threaded takes while other threads are taking.
+
+   ArenaTLAB is a thread local sub-block of a shared Arena. Each thread keeps its own and takes
+   from it without touching the shared Arena until it runs out, then grabs a new block with
+   Arena_take_atomic. Requests bigger than half a block go straight to the shared Arena.
+ */
+#if !defined(LCF_MEMORY_TLAB_SIZE)
+ #define LCF_MEMORY_TLAB_SIZE KB(64)
+#endif
+#if !defined(LCF_MEMORY_CACHE_LINE)
+ #define LCF_MEMORY_CACHE_LINE 64
+#endif
+
+void* Arena_take_atomic(Arena *a, u64 size, u32 alignment);
+
+struct ArenaTLAB {
+    Arena *arena;
+    u8 *pos;
+    u8 *end;
+    u64 block_size;
+};
+typedef struct ArenaTLAB ArenaTLAB;
+
+ArenaTLAB ArenaTLAB_begin(Arena *a, u64 block_size); /* block_size of 0 uses LCF_MEMORY_TLAB_SIZE */
+void* ArenaTLAB_take(ArenaTLAB *t, u64 size, u32 alignment);
+#define ArenaTLAB_take_array(t, type, count) ((type*) ArenaTLAB_take(t, sizeof(type)*(count), (u32) LCF_MEMORY_ALIGNMENT))
+#define ArenaTLAB_take_struct(t, type) ((type*) ArenaTLAB_take(t, sizeof(type), (u32) LCF_MEMORY_ALIGNMENT))
+
 /* Reset Arena to a certain position */
 void Arena_reset(Arena *a, u64 pos);
 void Arena_resetp(Arena *a, void* previous_alloc);
 
+/* Release committed memory past needed_pos, or past the current pos if needed_pos is 0 */
+void Arena_decommit(Arena *a, u64 needed_pos);
+
+/* Snapshots
+   Arena_snapshot saves the Arena so Arena_restore can bring it back to that point, pos and
+   contents. The first call copies everything in use to a shadow copy and write protects it.
+   After that, Arena_snapshot and Arena_restore only copy the pages written since the last
+   snapshot (tracked with LCF_MEMORY_watch_writes), so they cost about as much as what changed
+   rather than the size of the Arena. Without watch_writes every page is copied each time.
+
+   Pages are commit_size. The first write to each page after a snapshot is a fault handled in
+   user space, so while a snapshot is held the OS can't write into the Arena directly (eg.
+   read() into a buffer from it fails with EFAULT). Arena_snapshot and Arena_restore must not
+   run while other threads write to the Arena. Not for chained arenas.
+ */
+struct ArenaSnapshot {
+    u64 pos; /* Arena pos when the snapshot was taken */
+    u64 pages; /* Pages from the start of the Arena that are saved */
+    u64 released; /* Pages from here were decommitted or protected since, so aren't watched */
+    u64 page_size;
+    u64 copied; /* Pages copied by the last Arena_snapshot or Arena_restore */
+    s32 watching; /* 0 if writes aren't tracked and every page is copied */
+    u8 *shadow;
+    u64 shadow_commit;
+    u64 size; /* Of this reservation, the struct then the dirty bitmap */
+    u64 *dirty;
+};
+typedef struct ArenaSnapshot ArenaSnapshot;
+
+ArenaSnapshot* Arena_snapshot(Arena *a); /* Returns 0 if the shadow copy can't be made */
+void Arena_restore(Arena *a);
+void Arena_snapshot_end(Arena *a); /* Stop tracking and free the shadow copy, also done by Arena_destroy */
+
 /* Arena sessions - wraps resetting memory */
 struct ArenaSession {
     Arena *arena;
@@ -124,6 +445,179 @@ ArenaSession Scratch_session_custom(Arena** conflicts, s32 n);
     ArenaSession session = Scratch_session(), \
     ArenaSession_end(session))
 
+/* Pools
+   Fixed size slots carved out of an Arena, with an intrusive free list so slots can be freed
+   and reused in O(1). Pool_reset drops every slot at once by resetting the Arena back to where
+   the Pool was created, so that assumes nothing else took from the Arena after the Pool.
+
+   Pool_take and Pool_free are single threaded. To share a Pool between threads, give each one a
+   PoolCache and only go through those. A cache holds up to LCF_MEMORY_POOL_CACHE_COUNT slots and
+   only locks the Pool to move half of that at a time.
+ */
+#if !defined(LCF_MEMORY_POOL_CACHE_COUNT)
+ #define LCF_MEMORY_POOL_CACHE_COUNT 64
+#endif
+
+struct PoolSlot {
+    struct PoolSlot *next;
+};
+typedef struct PoolSlot PoolSlot;
+
+struct Pool {
+    Arena *arena;
+    u64 base_pos;
+    u64 slot_size;
+    u32 alignment;
+    u64 lock;
+    PoolSlot *free;
+    u64 slots; /* slots carved from the arena so far */
+};
+typedef struct Pool Pool;
+
+Pool* Pool_create(Arena *a, u64 slot_size, u32 alignment);
+void* Pool_take(Pool *p);
+void* Pool_take_zero(Pool *p);
+void Pool_free(Pool *p, void *slot);
+void Pool_reset(Pool *p);
+#define Pool_default(a, type) Pool_create(a, sizeof(type), (u32) LCF_MEMORY_ALIGNMENT)
+#define Pool_take_struct(p, type) ((type*) Pool_take(p))
+#define Pool_take_struct_zero(p, type) ((type*) Pool_take_zero(p))
+
+struct PoolCache {
+    Pool *pool;
+    PoolSlot *free;
+    u32 count;
+};
+typedef struct PoolCache PoolCache;
+
+PoolCache PoolCache_begin(Pool *p);
+void PoolCache_end(PoolCache *c); /* Gives all cached slots back to the Pool */
+void* PoolCache_take(PoolCache *c);
+void PoolCache_free(PoolCache *c, void *slot);
+
+/* Virtual Arrays
+   A VArray reserves address space for max_count elements up front and commits it as the array
+   grows, so it never moves and pointers to elements stay valid. Memory comes straight from
+   LCF_MEMORY_reserve/commit rather than an Arena. Commits double up to LCF_MEMORY_COMMIT_GROW_MAX.
+ */
+struct VArray {
+    u8 *data;
+    u64 len; /* in elements */
+    u64 elem_size;
+    u64 commit_pos; /* in bytes */
+    u64 size; /* reserved bytes */
+    u32 commit_size;
+};
+typedef struct VArray VArray;
+
+VArray VArray_create_custom(u64 elem_size, u64 max_count);
+#define VArray_create(type, max_count) VArray_create_custom(sizeof(type), max_count)
+void VArray_destroy(VArray *v);
+void* VArray_push(VArray *v); /* Returns the new element, zeroed, or 0 when full */
+void* VArray_append(VArray *v, void *elems, u64 count); /* Returns the first new element, or 0 when full */
+void* VArray_pop(VArray *v); /* Returns the removed element, valid until the next push */
+void VArray_reset(VArray *v, u64 len); /* Truncate to len elements, keeps memory committed */
+#define VArray_get(v, type, i) (((type*) (v)->data) + (i))
+#define VArray_push_struct(v, type) ((type*) VArray_push(v))
+
+/* Frame Arenas
+   count Arenas used in turn, one per frame. Frame_begin moves on to the next one and resets it,
+   so memory taken during a frame stays valid for count-1 frames after it. With 2, last frame's
+   data can still be read while the next frame is built. A frame is freed with one reset.
+
+   The highest pos each Arena reached during its frame is recorded as the peak of that frame,
+   including memory taken and given back by sessions in between. Memory taken before the first
+   Frame_begin counts as frame 0.
+ */
+#if !defined(LCF_MEMORY_FRAMES_MAX)
+ #define LCF_MEMORY_FRAMES_MAX 4
+#endif
+
+struct Frames {
+    Arena *arena[LCF_MEMORY_FRAMES_MAX];
+    u32 count;
+    u64 frame; /* Number of the current frame */
+    u64 peak[LCF_MEMORY_FRAMES_MAX]; /* Of the last finished frame in each arena */
+    u64 last_peak; /* Of the frame ended by the last Frame_begin */
+    u64 max_peak; /* Over all finished frames */
+};
+typedef struct Frames Frames;
+
+Frames Frames_create_custom(u32 count, Arena params);
+#ifndef __cplusplus
+#define Frames_create(count, ...) Frames_create_custom(count, (Arena){ \
+    .size = LCF_MEMORY_ARENA_SIZE, \
+    .commit_size = LCF_MEMORY_COMMIT_SIZE, \
+    .alignment = LCF_MEMORY_ALIGNMENT, \
+    __VA_ARGS__ \
+})
+#endif
+void Frames_destroy(Frames *f);
+Arena* Frame_begin(Frames *f); /* Returns the Arena for the new frame */
+Arena* Frame_arena(Frames *f, u32 frames_ago); /* 0 is the current frame, up to count-1 */
+
+/* Instrumentation
+   With LCF_MEMORY_INSTRUMENT every Arena gets an ArenaStats, and all live arenas (including the
+   per-thread scratch arenas) are kept in a global registry. The take macros below record the
+   __FILE__/__LINE__ of the caller, so bytes can be attributed to call sites.
+   Commit and decommit counts are summed from the blocks when reporting.
+ */
+#if !defined(LCF_MEMORY_INSTRUMENT_SITES)
+ #define LCF_MEMORY_INSTRUMENT_SITES 256 /* Per arena, must be a power of 2 */
+#endif
+
+#if LCF_MEMORY_INSTRUMENT
+struct ArenaSite {
+    u64 key;
+    char *file;
+    u32 line;
+    u64 takes;
+    u64 bytes;
+};
+typedef struct ArenaSite ArenaSite;
+
+struct ArenaStats {
+    struct ArenaStats *next;
+    struct ArenaStats *prev;
+    Arena *arena;
+    char *name;
+    char *file; /* Where the arena was created */
+    u32 line;
+    
+    u64 takes;
+    u64 bytes;
+    u64 peak_pos;
+    u64 peak_commit_pos;
+    ArenaSite site[LCF_MEMORY_INSTRUMENT_SITES];
+};
+typedef struct ArenaStats ArenaStats;
+
+ArenaStats* ArenaStats_first(void); /* Registry of live arenas, follow ->next */
+u64 ArenaStats_commits(ArenaStats *s);
+u64 ArenaStats_decommits(ArenaStats *s);
+struct StrList ArenaStats_report(Arena *out); /* One line per arena, then its sites by bytes */
+#define Arena_set_name(a, n) ((a)->stats->name = (n))
+
+/* Call sites are passed through thread locals so the take functions keep their signatures */
+extern per_thread char *_arena_site_file;
+extern per_thread u32 _arena_site_line;
+#define LCF_MEMORY_SITE(call) (_arena_site_file = __FILE__, _arena_site_line = __LINE__, call)
+
+#define Arena_create_custom(...) LCF_MEMORY_SITE((Arena_create_custom)(__VA_ARGS__))
+#define Arena_take(a, size) LCF_MEMORY_SITE((Arena_take)(a, size))
+#define Arena_take_custom(a, size, alignment) LCF_MEMORY_SITE((Arena_take_custom)(a, size, alignment))
+#define Arena_take_zero(a, size) LCF_MEMORY_SITE((Arena_take_zero)(a, size))
+#define Arena_take_zero_custom(a, size, alignment) LCF_MEMORY_SITE((Arena_take_zero_custom)(a, size, alignment))
+#define Arena_grow(a, ptr, old_size, new_size) LCF_MEMORY_SITE((Arena_grow)(a, ptr, old_size, new_size))
+#define Arena_take_atomic(a, size, alignment) LCF_MEMORY_SITE((Arena_take_atomic)(a, size, alignment))
+#define ArenaTLAB_take(t, size, alignment) LCF_MEMORY_SITE((ArenaTLAB_take)(t, size, alignment))
+#define Pool_take(p) LCF_MEMORY_SITE((Pool_take)(p))
+#define Pool_take_zero(p) LCF_MEMORY_SITE((Pool_take_zero)(p))
+#define PoolCache_take(c) LCF_MEMORY_SITE((PoolCache_take)(c))
+#else
+#define Arena_set_name(a, n) ((void)0)
+#endif
+
 /* Implements internal Stack and Queue operations on linked lists. Implemented as macros
    to be useful with arbitrary data structures in C and C++ */
 #define lcfNextsym next
@@ -156,6 +650,43 @@ ArenaSession Scratch_session_custom(Arena** conflicts, s32 n);
 #define PushQFront(l,n) PushQFrontCustom((l)->first,(l)->last,n,lcfNextsym,lcfCheckNull,lcfNullify)
 #define PopQ(l,o) PopQCustom((l)->first,(l)->last,o,lcfNextsym,lcfNullify)
 
+/* Lock-free versions of the above, for any struct with a next pointer. Both are zero initialized.
+   AtomicStack is a Treiber stack. The head packs a 48 bit pointer with a 16 bit tag that changes
+   on every push and pop, so a pop can't succeed on a head that was popped and pushed back (ABA).
+   Pops read next of nodes other threads may have popped, so nodes have to stay mapped, which
+   holds for memory from an Arena or Pool.
+   AtomicQueue is Vyukov's intrusive MPSC queue. Any thread can push, only one thread may pop.
+   A pop can return 0 while a push is half done, the node shows up on a later pop.
+   REF(lcf) https://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+ */
+struct AtomicStack {
+    u64 head;
+};
+typedef struct AtomicStack AtomicStack;
+
+struct AtomicQueue {
+    u64 head; /* Last pushed */
+    void *tail; /* Next to pop, only touched by the consumer */
+    void *stub; /* next field of the stub node */
+};
+typedef struct AtomicQueue AtomicQueue;
+
+void _AtomicStack_push(AtomicStack *s, void *node, u64 next_offset);
+void* _AtomicStack_pop(AtomicStack *s, u64 next_offset);
+void _AtomicQueue_push(AtomicQueue *q, void *node, u64 next_offset);
+void* _AtomicQueue_pop(AtomicQueue *q, u64 next_offset);
+
+#define lcfNextOffset(node,nextsym) ((u64)((u8*)&(node)->nextsym - (u8*)(node)))
+#define PushSAtomicCustom(s,node,nextsym) _AtomicStack_push(s, node, lcfNextOffset(node,nextsym))
+#define PopSAtomicCustom(s,type,nextsym) ((type*) _AtomicStack_pop(s, MEMBER_OFFSET(type,nextsym)))
+#define PushQAtomicCustom(q,node,nextsym) _AtomicQueue_push(q, node, lcfNextOffset(node,nextsym))
+#define PopQAtomicCustom(q,type,nextsym) ((type*) _AtomicQueue_pop(q, MEMBER_OFFSET(type,nextsym)))
+
+#define PushSAtomic(s,n) PushSAtomicCustom(s,n,lcfNextsym)
+#define PopSAtomic(s,type) PopSAtomicCustom(s,type,lcfNextsym)
+#define PushQAtomic(q,n) PushQAtomicCustom(q,n,lcfNextsym)
+#define PopQAtomic(q,type) PopQAtomicCustom(q,type,lcfNextsym)
+
 /* TODO: doubly linked list macros (haven't needed them yet) */
 /* TODO: concat two lists */
 
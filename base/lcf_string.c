@@ -1,9 +1,53 @@
 #include "lcf_string.h"
-#include <string.h> /* only for memset, memcpy */
+#include <string.h> /* only for memset, memcpy, memcmp */
 
 #define STB_SPRINTF_IMPLEMENTATION
 #include "../libs/stb_sprintf.h"
 
+#if LCF_STRING_SIMD
+ #include <immintrin.h>
+#endif
+
+/* SIMD helpers, a vector is STR_VEC bytes and the comparison masks fit in a u32 */
+#if LCF_STRING_SIMD == LCF_STRING_AVX2
+ #define STR_VEC 32
+ typedef __m256i str_vec;
+ #define str_vec_load(p) _mm256_load_si256((__m256i*)(p))
+ #define str_vec_loadu(p) _mm256_loadu_si256((__m256i*)(p))
+ #define str_vec_set1(c) _mm256_set1_epi8((char)(c))
+ #define str_vec_eq(a, b) ((u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)))
+ #define str_vec_and(a, b) _mm256_and_si256(a, b)
+ #define str_vec_or(a, b) _mm256_or_si256(a, b)
+ #define str_vec_xor(a, b) _mm256_xor_si256(a, b)
+ #define str_vec_shr4(a) _mm256_srli_epi16(a, 4)
+ #define str_vec_table(p) _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*)(p)))
+ #define str_vec_shuffle(table, i) _mm256_shuffle_epi8(table, i)
+#elif LCF_STRING_SIMD == LCF_STRING_SSE2
+ #define STR_VEC 16
+ typedef __m128i str_vec;
+ #define str_vec_load(p) _mm_load_si128((__m128i*)(p))
+ #define str_vec_loadu(p) _mm_loadu_si128((__m128i*)(p))
+ #define str_vec_set1(c) _mm_set1_epi8((char)(c))
+ #define str_vec_eq(a, b) ((u32) _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)))
+ #define str_vec_and(a, b) _mm_and_si128(a, b)
+ #define str_vec_or(a, b) _mm_or_si128(a, b)
+ #define str_vec_xor(a, b) _mm_xor_si128(a, b)
+ #define str_vec_shr4(a) _mm_srli_epi16(a, 4)
+ #define str_vec_table(p) _mm_loadu_si128((__m128i*)(p))
+ #if LCF_STRING_SHUFFLE
+  #define str_vec_shuffle(table, i) _mm_shuffle_epi8(table, i) /* SSSE3 */
+ #endif
+#endif
+#define STR_VEC_ALIGN(p) ((u8*)((upr)(p) & ~(upr)(STR_VEC-1)))
+
+#if COMPILER_CL
+ #define LCF_STRING_NO_SANITIZE __declspec(no_sanitize_address)
+#elif COMPILER_CLANG || COMPILER_GCC
+ #define LCF_STRING_NO_SANITIZE __attribute__((no_sanitize_address, no_sanitize_thread))
+#else
+ #define LCF_STRING_NO_SANITIZE
+#endif
+
 /** ASCII                            **/
 #define RET_STR(s,l)                           \
     str _s = ZERO_STRUCT;                      \
@@ -129,12 +173,21 @@ str str_make_cstring(Arena *a, str s) {
 }
 
 str strfv(Arena *a, char *fmt, va_list args) {
+    /* Format once into a guess, then give back what wasn't used. Only formats twice when the
+       guess was too small. */
     str result = ZERO_STRUCT;
+    s64 guess = 256;
     va_list args2;
     va_copy(args2, args);
-    result.len = stbsp_vsnprintf(0, 0, fmt, args2);
-    result.str = Arena_take_array(a, char, result.len+1);
-    stbsp_vsnprintf(result.str, (s32)result.len+1, fmt, args);
+    result.str = Arena_take_array(a, char, guess);
+    result.len = stbsp_vsnprintf(result.str, (s32)guess, fmt, args);
+    if (result.len+1 > guess) {
+        result.str = Arena_grow_array(a, result.str, char, guess, result.len+1);
+        stbsp_vsnprintf(result.str, (s32)result.len+1, fmt, args2);
+    } else {
+        Arena_shrink(a, result.str, guess, result.len+1);
+    }
+    va_end(args2);
     return result;
 }
 
@@ -194,6 +247,49 @@ s32 char_is_alphanum(char c) {
 s32 str_contains_char(str s, char find) {
     return str_char_location(s,find) != LCF_STRING_NO_MATCH;
 }
+#if LCF_STRING_SIMD
+/* NOTE(lcf) The first and last vectors are loaded from aligned addresses and can hold bytes
+   outside of s, those bits are masked off. Each load has at least one byte of s in it, so it
+   never touches a page s isn't on. */
+LCF_STRING_NO_SANITIZE s64 str_char_location(str s, char find) {
+    if (s.len <= 0) {
+        return LCF_STRING_NO_MATCH;
+    }
+    u8 *start = (u8*) s.str;
+    u8 *end = start + s.len;
+    u8 *block = STR_VEC_ALIGN(start);
+    str_vec c = str_vec_set1(find);
+    u32 mask = str_vec_eq(str_vec_load(block), c) & (~0u << (start - block));
+    while (!mask) {
+        block += STR_VEC;
+        if (block >= end) {
+            return LCF_STRING_NO_MATCH;
+        }
+        mask = str_vec_eq(str_vec_load(block), c);
+    }
+    s64 i = (block - start) + bit_scan_forward_u64(mask);
+    return (i < s.len)? i : LCF_STRING_NO_MATCH;
+}
+
+LCF_STRING_NO_SANITIZE s64 str_char_location_backward(str s, char find) {
+    if (s.len <= 0) {
+        return LCF_STRING_NO_MATCH;
+    }
+    u8 *start = (u8*) s.str;
+    u8 *block = STR_VEC_ALIGN(start + s.len - 1);
+    str_vec c = str_vec_set1(find);
+    u32 mask = str_vec_eq(str_vec_load(block), c) & (~0u >> (31 - (start + s.len - 1 - block)));
+    while (!mask) {
+        if (block <= start) {
+            return LCF_STRING_NO_MATCH;
+        }
+        block -= STR_VEC;
+        mask = str_vec_eq(str_vec_load(block), c);
+    }
+    s64 i = (block - start) + bit_scan_reverse_u64(mask);
+    return (i >= 0)? i : LCF_STRING_NO_MATCH;
+}
+#else
 s64 str_char_location(str s, char find) {
     str_iter(s, i, c) {
         if (c == find) {
@@ -210,6 +306,7 @@ s64 str_char_location_backward(str s, char find) {
     }
     return LCF_STRING_NO_MATCH;
 }
+#endif
 s64 str_first_whitespace_location(str s) {
     if (str_is_empty(s)) {
         return LCF_STRING_NO_MATCH;
@@ -225,24 +322,160 @@ s64 str_first_whitespace_location(str s) {
 s32 str_contains_substring(str s, str sub) {
     return str_substring_location(s,sub) != LCF_STRING_NO_MATCH;
 }
-s64 str_substring_location(str s, str sub) {
-    u32 match = 0;
-    if (str_is_empty(s) || str_is_empty(sub)) {
-        return LCF_STRING_NO_MATCH;
-    }
-    str_iter(s, i, c) {
-        if (c == sub.str[match]) {
-            match++;
-            if (match == sub.len) {
-                return i+1-match;
+
+/* Two-Way string matching. The needle is split at a critical factorization, the right part is
+   matched left to right and then the left part, and on a mismatch the shift is known from the
+   split and the period, so the search is linear. A Horspool table on the byte under the end of
+   the needle skips ahead before comparing anything, which makes it sublinear in practice.
+   REF(lcf) Crochemore, Perrin. Two-way string-matching. J. ACM 38(3), 1991.
+   REF(lcf) glibc str-two-way.h (two_way_long_needle), which this follows. */
+internal s64 _str_maximal_suffix(u8 *x, s64 m, s64 *period, s32 reverse) {
+    s64 suffix = -1, j = 0, k = 1, p = 1;
+    while (j + k < m) {
+        u8 a = x[j + k];
+        u8 b = x[suffix + k];
+        if (reverse? a > b : a < b) {
+            j += k;
+            k = 1;
+            p = j - suffix;
+        } else if (a == b) {
+            if (k != p) {
+                k++;
+            } else {
+                j += p;
+                k = 1;
             }
         } else {
-            match = 0;
+            suffix = j++;
+            k = p = 1;
+        }
+    }
+    *period = p;
+    return suffix;
+}
+
+internal s64 _str_two_way(u8 *s, s64 n, u8 *x, s64 m) {
+    s64 period, period_reverse;
+    s64 suffix = _str_maximal_suffix(x, m, &period, 0);
+    s64 suffix_reverse = _str_maximal_suffix(x, m, &period_reverse, 1);
+    if (suffix_reverse > suffix) {
+        suffix = suffix_reverse;
+        period = period_reverse;
+    }
+    suffix++; /* Start of the right half */
+
+    s64 shift_table[256];
+    for (s32 c = 0; c < 256; c++) {
+        shift_table[c] = m;
+    }
+    for (s64 i = 0; i < m; i++) {
+        shift_table[x[i]] = m - i - 1;
+    }
+
+    if (memcmp(x, x + period, suffix) == 0) {
+        /* Periodic needle, remember how much of the left half is known to match after a shift */
+        s64 memory = 0;
+        for (s64 j = 0; j <= n - m; ) {
+            s64 shift = shift_table[s[j + m - 1]];
+            if (shift > 0) {
+                if (memory && shift < period) {
+                    shift = m - period;
+                }
+                memory = 0;
+                j += shift;
+                continue;
+            }
+            /* The last byte matched */
+            s64 i = MAX(suffix, memory);
+            while (i < m - 1 && x[i] == s[i + j]) {
+                i++;
+            }
+            if (i < m - 1) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+            i = suffix - 1;
+            while (i >= memory && x[i] == s[i + j]) {
+                i--;
+            }
+            if (i < memory) {
+                return j;
+            }
+            j += period;
+            memory = m - period;
+        }
+    } else {
+        period = MAX(suffix, m - suffix) + 1;
+        for (s64 j = 0; j <= n - m; ) {
+            s64 shift = shift_table[s[j + m - 1]];
+            if (shift > 0) {
+                j += shift;
+                continue;
+            }
+            s64 i = suffix;
+            while (i < m - 1 && x[i] == s[i + j]) {
+                i++;
+            }
+            if (i < m - 1) {
+                j += i - suffix + 1;
+                continue;
+            }
+            i = suffix - 1;
+            while (i >= 0 && x[i] == s[i + j]) {
+                i--;
+            }
+            if (i < 0) {
+                return j;
+            }
+            j += period;
         }
     }
     return LCF_STRING_NO_MATCH;
 }
 
+#if LCF_STRING_SIMD
+/* Short needles: compare the first and last byte of the needle at STR_VEC positions at once,
+   then check the middle only where both matched. All loads stay inside s.
+   REF(lcf) http://0x80.pl/articles/simd-strfind.html */
+internal s64 _str_find_short(u8 *s, s64 n, u8 *x, s64 m) {
+    str_vec first = str_vec_set1(x[0]);
+    str_vec last = str_vec_set1(x[m-1]);
+    s64 i = 0;
+    for (; i + m - 1 + STR_VEC <= n; i += STR_VEC) {
+        u32 mask = str_vec_eq(str_vec_loadu(s + i), first) & str_vec_eq(str_vec_loadu(s + i + m - 1), last);
+        while (mask) {
+            s64 at = i + bit_scan_forward_u64(mask);
+            if (memcmp(s + at + 1, x + 1, m - 2) == 0) {
+                return at;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; i + m <= n; i++) {
+        if (s[i] == x[0] && s[i + m - 1] == x[m-1] && memcmp(s + i + 1, x + 1, m - 2) == 0) {
+            return i;
+        }
+    }
+    return LCF_STRING_NO_MATCH;
+}
+#endif
+
+s64 str_substring_location(str s, str sub) {
+    if (str_is_empty(s) || str_is_empty(sub) || sub.len > s.len) {
+        return LCF_STRING_NO_MATCH;
+    }
+    if (sub.len == 1) {
+        return str_char_location(s, sub.str[0]);
+    }
+    #if LCF_STRING_SIMD
+    if (sub.len <= LCF_STRING_SHORT_NEEDLE) {
+        return _str_find_short((u8*) s.str, s.len, (u8*) sub.str, sub.len);
+    }
+    #endif
+    return _str_two_way((u8*) s.str, s.len, (u8*) sub.str, sub.len);
+}
+
 /* NOTE(lcf): similar to substring functions, but delims is used as a list of chars to
    look for instead of matching the entire substring. */
 s32 str_contains_delimiter(str s, str delims) {
@@ -255,15 +488,99 @@ s64 str_delimiter_location(str s, str delims) {
     if (str_is_empty(delims)) {
         return 0;
     }
-    str_iter(s, i, c) {
-        str_iter(delims, j, delim) {
-            if (c == delim) {
-                return i;
+    if (delims.len == 1) {
+        return str_char_location(s, delims.str[0]);
+    }
+    StrCharset set = StrCharset_from(delims);
+    return str_charset_location(s, &set);
+}
+
+StrCharset StrCharset_from(str chars) {
+    StrCharset set = ZERO_STRUCT;
+    str_iter(chars, i, c) {
+        StrCharset_add(&set, c);
+    }
+    return set;
+}
+
+void StrCharset_add(StrCharset *set, char c) {
+    u8 b = (u8) c;
+    set->bits[b >> 6] |= 1ull << (b & 63);
+    if (b < 128) {
+        set->low[b & 15] |= (u8) (1 << (b >> 4));
+    } else {
+        set->high[b & 15] |= (u8) (1 << ((b >> 4) - 8));
+    }
+}
+
+#if LCF_STRING_SIMD && LCF_STRING_SHUFFLE
+/* Each byte looks up its low nibble in low and high, which gives the row of the set holding
+   every byte with that low nibble. pshufb gives 0 for indices with the top bit set, so masking
+   with 0x8f picks low for bytes below 128 and flipping the top bit picks high for the rest.
+   The high nibble picks the bit to test in that row.
+   REF(lcf) http://0x80.pl/articles/simd-byte-lookup.html */
+static read_only u8 _str_charset_bit[16] = {
+    1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+};
+
+internal u32 _str_charset_match(str_vec v, str_vec low, str_vec high) {
+    str_vec index = str_vec_and(v, str_vec_set1(0x8f));
+    str_vec row = str_vec_or(str_vec_shuffle(low, index),
+                             str_vec_shuffle(high, str_vec_xor(index, str_vec_set1(0x80))));
+    str_vec bit = str_vec_shuffle(str_vec_table(_str_charset_bit),
+                                  str_vec_and(str_vec_shr4(v), str_vec_set1(0x0f)));
+    return str_vec_eq(str_vec_and(row, bit), bit);
+}
+
+/* NOTE(lcf) Same loads as str_char_location, see there. */
+LCF_STRING_NO_SANITIZE s64 str_charset_location(str s, StrCharset *set) {
+    if (s.len <= 0) {
+        return LCF_STRING_NO_MATCH;
+    }
+    u8 *start = (u8*) s.str;
+    u8 *end = start + s.len;
+    u8 *block = STR_VEC_ALIGN(start);
+    str_vec low = str_vec_table(set->low);
+    str_vec high = str_vec_table(set->high);
+    u32 mask = _str_charset_match(str_vec_load(block), low, high) & (~0u << (start - block));
+    if (!mask) {
+        /* Two vectors per step to keep more loads in flight */
+        block += STR_VEC;
+        for (; block + 2*STR_VEC <= end; block += 2*STR_VEC) {
+            u32 m0 = _str_charset_match(str_vec_load(block), low, high);
+            u32 m1 = _str_charset_match(str_vec_load(block + STR_VEC), low, high);
+            if (m0 | m1) {
+                if (!m0) {
+                    block += STR_VEC;
+                    m0 = m1;
+                }
+                mask = m0;
+                break;
+            }
+        }
+        while (!mask) {
+            if (block >= end) {
+                return LCF_STRING_NO_MATCH;
+            }
+            mask = _str_charset_match(str_vec_load(block), low, high);
+            if (!mask) {
+                block += STR_VEC;
             }
         }
     }
+    s64 i = (block - start) + bit_scan_forward_u64(mask);
+    return (i < s.len)? i : LCF_STRING_NO_MATCH;
+}
+#else
+s64 str_charset_location(str s, StrCharset *set) {
+    str_iter(s, i, c) {
+        if (StrCharset_has(set, c)) {
+            return i;
+        }
+    }
     return LCF_STRING_NO_MATCH;
 }
+#endif
 
 static read_only char LCF_CHAR_LOWER = 'a' - 'A';
 char char_lower(char c) {
@@ -374,6 +691,21 @@ str str_pop_at_first_delimiter(str *src, str delims) {
     return s;
 }
 
+str str_pop_at_first_charset(str *src, StrCharset *set) {
+    str s = *src;
+    s64 match = str_charset_location(s, set);
+    if (match == LCF_STRING_NO_MATCH) {
+        src->str = 0;
+        src->len = 0;
+    } else {
+        s64 delta = match + 1;
+        src->str = s.str + delta;
+        src->len = (s.len > delta)? s.len - delta : 0;
+        s.len = match;
+    }
+    return s;
+}
+
 str str_pop_at_first_whitespace(str *src) {
     str s = *src;
     s64 match = str_first_whitespace_location(s);
@@ -391,10 +723,167 @@ str str_pop_at_first_whitespace(str *src) {
 }
 
 
-/* Parsing */
+/* Parsing
+   Decimal and hex digits are read 8 at a time from a u64 (SWAR), or 16 at a time with SSE4.1.
+   Every byte is range checked at once: with the high bits cleared, adding 0x80 - lo to a byte
+   sets its high bit when it is >= lo, and nothing carries into the next byte. The digits are
+   then combined pairwise, 2 into 1 byte, 2 bytes into 16 bits and so on, with 3 multiplies for
+   decimal or shifts for hex. The first character is the low byte, so this is little endian.
+   REF(lcf) https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/ */
+#define STR_SWAR_ONES 0x0101010101010101ull
+#define STR_SWAR_HIGHS 0x8080808080808080ull
+
+static read_only u32 _str_pow10_u32[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* High bit of every byte in [lo, hi], lo > 0 and hi < 0x80 */
+internal u64 _str_swar_in_range(u64 x, u8 lo, u8 hi) {
+    u64 low7 = x & ~STR_SWAR_HIGHS;
+    u64 ge = low7 + (0x80 - lo)*STR_SWAR_ONES;
+    u64 gt = low7 + (0x7F - hi)*STR_SWAR_ONES;
+    return ge & ~gt & ~x & STR_SWAR_HIGHS;
+}
+
+internal u64 _str_swar_digits(u64 x, s32 base) {
+    if (base <= 10) {
+        return _str_swar_in_range(x, '0', (u8) ('0' + base - 1));
+    }
+    return _str_swar_in_range(x, '0', '9') | _str_swar_in_range(x | 0x20*STR_SWAR_ONES, 'a', 'f');
+}
+
+/* Leading digits of the 8 at p in base 10 or 16, their value goes in value */
+internal s32 _str_parse_digits8(char *p, s32 base, u64 *value) {
+    u64 x;
+    memcpy(&x, p, 8);
+    u64 alpha = 0;
+    u64 valid = _str_swar_in_range(x, '0', '9');
+    if (base == 16) {
+        alpha = _str_swar_in_range(x | 0x20*STR_SWAR_ONES, 'a', 'f');
+        valid |= alpha;
+    }
+    u64 invalid = ~valid & STR_SWAR_HIGHS;
+    s32 k = invalid? (s32) (bit_scan_forward_u64(invalid) >> 3) : 8;
+    if (k == 0) {
+        *value = 0;
+        return 0;
+    }
+
+    /* Bytes past the digits shift out the top, and zeros come in as leading digits */
+    u32 shift = 8*(8 - k);
+    if (base == 10) {
+        u64 d = (x - '0'*STR_SWAR_ONES) << shift;
+        d = 10*d + (d >> 8);
+        d = (((d & 0x000000FF000000FFull)*(100 + (1000000ull << 32)))
+             + (((d >> 16) & 0x000000FF000000FFull)*(1 + (10000ull << 32)))) >> 32;
+        *value = (u32) d;
+    } else {
+        u64 d = ((x & 0x0F*STR_SWAR_ONES) + (alpha >> 7)*9) << shift;
+        d = ((d << 4) | (d >> 8)) & 0x00FF00FF00FF00FFull;
+        d = ((d << 8) | (d >> 16)) & 0x0000FFFF0000FFFFull;
+        *value = (u32) ((d << 16) | (d >> 32));
+    }
+    return k;
+}
+
+#if LCF_STRING_SSE41
+static read_only u8 _str_digits_shift[32] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+/* Same for 16 digits, pshufb moves k digits to the end of the vector */
+internal s32 _str_parse_digits16(char *p, s32 base, u64 *value) {
+    __m128i x = _mm_loadu_si128((__m128i*) p);
+    __m128i d = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+    __m128i valid = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+    if (base == 16) {
+        __m128i a = _mm_sub_epi8(_mm_or_si128(x, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i alpha = _mm_cmpeq_epi8(_mm_min_epu8(a, _mm_set1_epi8(5)), a);
+        d = _mm_blendv_epi8(d, _mm_add_epi8(a, _mm_set1_epi8(10)), alpha);
+        valid = _mm_or_si128(valid, alpha);
+    }
+    u32 invalid = ~(u32) _mm_movemask_epi8(valid) & 0xFFFF;
+    s32 k = invalid? (s32) bit_scan_forward_u64(invalid) : 16;
+    if (k < 16) {
+        d = _mm_shuffle_epi8(d, _mm_loadu_si128((__m128i*) (_str_digits_shift + k)));
+    }
+
+    if (base == 10) {
+        d = _mm_maddubs_epi16(d, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+        d = _mm_madd_epi16(d, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+        d = _mm_packus_epi32(d, d);
+        d = _mm_madd_epi16(d, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+        *value = (u64) (u32) _mm_cvtsi128_si32(d)*100000000 + (u32) _mm_extract_epi32(d, 1);
+    } else {
+        d = _mm_maddubs_epi16(d, _mm_setr_epi8(16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1, 16, 1));
+        d = _mm_packus_epi16(d, d);
+        d = _mm_shuffle_epi8(d, _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 7, 6, 5, 4, 3, 2, 1, 0));
+        _mm_storel_epi64((__m128i*) value, d);
+    }
+    return k;
+}
+#endif
+
+/* Leading base 10 or 16 digits of s, s.len must be capped so the value fits in a u64 */
+internal s64 _str_parse_digits(str s, s32 base, u64 *value) {
+    s64 i = 0;
+    u64 n = 0;
+    s32 full = 1;
+    #if LCF_STRING_SSE41
+    if (s.len >= 16) {
+        i = _str_parse_digits16(s.str, base, &n);
+        full = (i == 16);
+    }
+    #endif
+    while (full && s.len - i >= 8) {
+        u64 v;
+        s32 k = _str_parse_digits8(s.str + i, base, &v);
+        n = (base == 10)? n*_str_pow10_u32[k] + v : (n << 4*k) | v;
+        i += k;
+        full = (k == 8);
+    }
+    for (; full && i < s.len; i++) {
+        u8 digit = s.str[i] - '0';
+        if (base == 16 && digit >= 10) {
+            digit = (u8) ((s.str[i]|32) - 'a');
+            digit = (digit < 6)? digit + 10 : 16;
+        }
+        if (digit >= base) {
+            break;
+        }
+        n = base*n + digit;
+    }
+    *value = n;
+    return i;
+}
+
+s64 str_count_digits(str s, s32 base) {
+    s64 i = 0;
+    for (; s.len - i >= 8; i += 8) {
+        u64 x;
+        memcpy(&x, s.str + i, 8);
+        u64 invalid = ~_str_swar_digits(x, base) & STR_SWAR_HIGHS;
+        if (invalid) {
+            return i + (bit_scan_forward_u64(invalid) >> 3);
+        }
+    }
+    for (; i < s.len; i++) {
+        u8 digit = s.str[i] - '0';
+        if (base == 16 && digit >= 10) {
+            digit = (u8) ((s.str[i]|32) - 'a');
+            digit = (digit < 6)? digit + 10 : 16;
+        }
+        if (digit >= base) {
+            break;
+        }
+    }
+    return i;
+}
+
 u64 str_to_u64(str s, s32 *failure) {
     s32 base = 10;
-    if (s.str[0] == '0') {
+    if (s.len > 1 && s.str[0] == '0') {
         if (s.str[1] == 'x') {
             base = 16;
             s.str += 2; s.len -= 2;
@@ -407,7 +896,7 @@ u64 str_to_u64(str s, s32 *failure) {
         }
     }
 
-    s32 i = 0;
+    s64 i = 0;
     u64 n = 0;
     switch (base) {
         case 2: {
@@ -429,27 +918,15 @@ u64 str_to_u64(str s, s32 *failure) {
                 }
                 n = 8*n + digit;
             }
+            i += 1; // the leading 0 is a digit too
         } break;
         case 10: {
             s.len = MIN(s.len, 19); // 19 = log(2^64)/log(10)
-            for (i = 0; i < s.len; i++) {
-                u8 digit = s.str[i] - '0';
-                if (digit >= 10) {
-                    break;
-                }
-                n = 10*n + digit;
-            }
+            i = _str_parse_digits(s, 10, &n);
         } break;
         case 16: {
             s.len = MIN(s.len, 16); // 16 = log(2^64)/log(16)
-            for (i = 0; i < s.len; i++) {
-                u8 digit = s.str[i] - '0';
-                if (digit >= 10) digit = (s.str[i]|32) + 10 - 'a';
-                if (digit >= 16) {
-                    break;
-                }
-                n = 16*n + digit;
-            }
+            i = _str_parse_digits(s, 16, &n);
         } break;
     }
 
@@ -484,13 +961,666 @@ s64 str_to_s64(str s, s32 *failure) {
 #define NAN (0.0/0.0)
 #endif
 
+/* Float parsing
+   Decimal strings are read into a 19 digit mantissa w and a power of ten q. Small exact cases
+   are one float multiply or divide (Clinger). Everything else goes through Eisel-Lemire: w times
+   a 128 bit approximation of 5^q gives the leading bits of the result, which is provably enough
+   to round correctly for any w that fits 64 bits. When digits past the 19th were dropped, w and
+   w+1 bracket the real value, and if they round differently the digits are run through an exact
+   decimal conversion instead. That is rare (long inputs near a halfway point).
+   REF(lcf) Lemire. Number Parsing at a Gigabyte per Second. https://arxiv.org/abs/2101.11408
+   REF(lcf) Mushtak, Lemire. Fast number parsing without fallback. https://arxiv.org/abs/2212.06644
+   REF(lcf) Tao. https://nigeltao.github.io/blog/2020/parse-number-f64-simple.html */
+#define STR_F64_MIN_POW10 (-342)
+#define STR_F64_MAX_POW10 308
+
+/* 5^q normalized to 128 bits, {high, low}, for q in [-342, 308]. Generated with:
+     for q in range(-342, 309):
+         if q < 0:
+             p = 5**-q; z = p.bit_length()
+             c = 2**(z + 127)//p + 1 if q >= -27 else 2**(2*z + 128)//p + 1
+         else:
+             c = 5**q
+         while c < 1 << 127: c *= 2
+         while c >= 1 << 128: c //= 2 */
+static read_only u64 _str_pow5_128[STR_F64_MAX_POW10 - STR_F64_MIN_POW10 + 1][2] = {
+    {0xeef453d6923bd65a, 0x113faa2906a13b3f}, {0x9558b4661b6565f8, 0x4ac7ca59a424c507},
+    {0xbaaee17fa23ebf76, 0x5d79bcf00d2df649}, {0xe95a99df8ace6f53, 0xf4d82c2c107973dc},
+    {0x91d8a02bb6c10594, 0x79071b9b8a4be869}, {0xb64ec836a47146f9, 0x9748e2826cdee284},
+    {0xe3e27a444d8d98b7, 0xfd1b1b2308169b25}, {0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7},
+    {0xb208ef855c969f4f, 0xbdbd2d335e51a935}, {0xde8b2b66b3bc4723, 0xad2c788035e61382},
+    {0x8b16fb203055ac76, 0x4c3bcb5021afcc31}, {0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d},
+    {0xd953e8624b85dd78, 0xd71d6dad34a2af0d}, {0x87d4713d6f33aa6b, 0x8672648c40e5ad68},
+    {0xa9c98d8ccb009506, 0x680efdaf511f18c2}, {0xd43bf0effdc0ba48, 0x0212bd1b2566def2},
+    {0x84a57695fe98746d, 0x014bb630f7604b57}, {0xa5ced43b7e3e9188, 0x419ea3bd35385e2d},
+    {0xcf42894a5dce35ea, 0x52064cac828675b9}, {0x818995ce7aa0e1b2, 0x7343efebd1940993},
+    {0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8}, {0xca66fa129f9b60a6, 0xd41a26e077774ef6},
+    {0xfd00b897478238d0, 0x8920b098955522b4}, {0x9e20735e8cb16382, 0x55b46e5f5d5535b0},
+    {0xc5a890362fddbc62, 0xeb2189f734aa831d}, {0xf712b443bbd52b7b, 0xa5e9ec7501d523e4},
+    {0x9a6bb0aa55653b2d, 0x47b233c92125366e}, {0xc1069cd4eabe89f8, 0x999ec0bb696e840a},
+    {0xf148440a256e2c76, 0xc00670ea43ca250d}, {0x96cd2a865764dbca, 0x380406926a5e5728},
+    {0xbc807527ed3e12bc, 0xc605083704f5ecf2}, {0xeba09271e88d976b, 0xf7864a44c633682e},
+    {0x93445b8731587ea3, 0x7ab3ee6afbe0211d}, {0xb8157268fdae9e4c, 0x5960ea05bad82964},
+    {0xe61acf033d1a45df, 0x6fb92487298e33bd}, {0x8fd0c16206306bab, 0xa5d3b6d479f8e056},
+    {0xb3c4f1ba87bc8696, 0x8f48a4899877186c}, {0xe0b62e2929aba83c, 0x331acdabfe94de87},
+    {0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14}, {0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9},
+    {0xdb71e91432b1a24a, 0xc9e82cd9f69d6150}, {0x892731ac9faf056e, 0xbe311c083a225cd2},
+    {0xab70fe17c79ac6ca, 0x6dbd630a48aaf406}, {0xd64d3d9db981787d, 0x092cbbccdad5b108},
+    {0x85f0468293f0eb4e, 0x25bbf56008c58ea5}, {0xa76c582338ed2621, 0xaf2af2b80af6f24e},
+    {0xd1476e2c07286faa, 0x1af5af660db4aee1}, {0x82cca4db847945ca, 0x50d98d9fc890ed4d},
+    {0xa37fce126597973c, 0xe50ff107bab528a0}, {0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8},
+    {0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a}, {0x9faacf3df73609b1, 0x77b191618c54e9ac},
+    {0xc795830d75038c1d, 0xd59df5b9ef6a2417}, {0xf97ae3d0d2446f25, 0x4b0573286b44ad1d},
+    {0x9becce62836ac577, 0x4ee367f9430aec32}, {0xc2e801fb244576d5, 0x229c41f793cda73f},
+    {0xf3a20279ed56d48a, 0x6b43527578c1110f}, {0x9845418c345644d6, 0x830a13896b78aaa9},
+    {0xbe5691ef416bd60c, 0x23cc986bc656d553}, {0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8},
+    {0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9}, {0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53},
+    {0xe858ad248f5c22c9, 0xd1b3400f8f9cff68}, {0x91376c36d99995be, 0x23100809b9c21fa1},
+    {0xb58547448ffffb2d, 0xabd40a0c2832a78a}, {0xe2e69915b3fff9f9, 0x16c90c8f323f516c},
+    {0x8dd01fad907ffc3b, 0xae3da7d97f6792e3}, {0xb1442798f49ffb4a, 0x99cd11cfdf41779c},
+    {0xdd95317f31c7fa1d, 0x40405643d711d583}, {0x8a7d3eef7f1cfc52, 0x482835ea666b2572},
+    {0xad1c8eab5ee43b66, 0xda3243650005eecf}, {0xd863b256369d4a40, 0x90bed43e40076a82},
+    {0x873e4f75e2224e68, 0x5a7744a6e804a291}, {0xa90de3535aaae202, 0x711515d0a205cb36},
+    {0xd3515c2831559a83, 0x0d5a5b44ca873e03}, {0x8412d9991ed58091, 0xe858790afe9486c2},
+    {0xa5178fff668ae0b6, 0x626e974dbe39a872}, {0xce5d73ff402d98e3, 0xfb0a3d212dc8128f},
+    {0x80fa687f881c7f8e, 0x7ce66634bc9d0b99}, {0xa139029f6a239f72, 0x1c1fffc1ebc44e80},
+    {0xc987434744ac874e, 0xa327ffb266b56220}, {0xfbe9141915d7a922, 0x4bf1ff9f0062baa8},
+    {0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9}, {0xc4ce17b399107c22, 0xcb550fb4384d21d3},
+    {0xf6019da07f549b2b, 0x7e2a53a146606a48}, {0x99c102844f94e0fb, 0x2eda7444cbfc426d},
+    {0xc0314325637a1939, 0xfa911155fefb5308}, {0xf03d93eebc589f88, 0x793555ab7eba27ca},
+    {0x96267c7535b763b5, 0x4bc1558b2f3458de}, {0xbbb01b9283253ca2, 0x9eb1aaedfb016f16},
+    {0xea9c227723ee8bcb, 0x465e15a979c1cadc}, {0x92a1958a7675175f, 0x0bfacd89ec191ec9},
+    {0xb749faed14125d36, 0xcef980ec671f667b}, {0xe51c79a85916f484, 0x82b7e12780e7401a},
+    {0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810}, {0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15},
+    {0xdfbdcece67006ac9, 0x67a791e093e1d49a}, {0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0},
+    {0xaecc49914078536d, 0x58fae9f773886e18}, {0xda7f5bf590966848, 0xaf39a475506a899e},
+    {0x888f99797a5e012d, 0x6d8406c952429603}, {0xaab37fd7d8f58178, 0xc8e5087ba6d33b83},
+    {0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64}, {0x855c3be0a17fcd26, 0x5cf2eea09a55067f},
+    {0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e}, {0xd0601d8efc57b08b, 0xf13b94daf124da26},
+    {0x823c12795db6ce57, 0x76c53d08d6b70858}, {0xa2cb1717b52481ed, 0x54768c4b0c64ca6e},
+    {0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09}, {0xfe5d54150b090b02, 0xd3f93b35435d7c4c},
+    {0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf}, {0xc6b8e9b0709f109a, 0x359ab6419ca1091b},
+    {0xf867241c8cc6d4c0, 0xc30163d203c94b62}, {0x9b407691d7fc44f8, 0x79e0de63425dcf1d},
+    {0xc21094364dfb5636, 0x985915fc12f542e4}, {0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d},
+    {0x979cf3ca6cec5b5a, 0xa705992ceecf9c42}, {0xbd8430bd08277231, 0x50c6ff782a838353},
+    {0xece53cec4a314ebd, 0xa4f8bf5635246428}, {0x940f4613ae5ed136, 0x871b7795e136be99},
+    {0xb913179899f68584, 0x28e2557b59846e3f}, {0xe757dd7ec07426e5, 0x331aeada2fe589cf},
+    {0x9096ea6f3848984f, 0x3ff0d2c85def7621}, {0xb4bca50b065abe63, 0x0fed077a756b53a9},
+    {0xe1ebce4dc7f16dfb, 0xd3e8495912c62894}, {0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c},
+    {0xb080392cc4349dec, 0xbd8d794d96aacfb3}, {0xdca04777f541c567, 0xecf0d7a0fc5583a0},
+    {0x89e42caaf9491b60, 0xf41686c49db57244}, {0xac5d37d5b79b6239, 0x311c2875c522ced5},
+    {0xd77485cb25823ac7, 0x7d633293366b828b}, {0x86a8d39ef77164bc, 0xae5dff9c02033197},
+    {0xa8530886b54dbdeb, 0xd9f57f830283fdfc}, {0xd267caa862a12d66, 0xd072df63c324fd7b},
+    {0x8380dea93da4bc60, 0x4247cb9e59f71e6d}, {0xa46116538d0deb78, 0x52d9be85f074e608},
+    {0xcd795be870516656, 0x67902e276c921f8b}, {0x806bd9714632dff6, 0x00ba1cd8a3db53b6},
+    {0xa086cfcd97bf97f3, 0x80e8a40eccd228a4}, {0xc8a883c0fdaf7df0, 0x6122cd128006b2cd},
+    {0xfad2a4b13d1b5d6c, 0x796b805720085f81}, {0x9cc3a6eec6311a63, 0xcbe3303674053bb0},
+    {0xc3f490aa77bd60fc, 0xbedbfc4411068a9c}, {0xf4f1b4d515acb93b, 0xee92fb5515482d44},
+    {0x991711052d8bf3c5, 0x751bdd152d4d1c4a}, {0xbf5cd54678eef0b6, 0xd262d45a78a0635d},
+    {0xef340a98172aace4, 0x86fb897116c87c34}, {0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0},
+    {0xbae0a846d2195712, 0x8974836059cca109}, {0xe998d258869facd7, 0x2bd1a438703fc94b},
+    {0x91ff83775423cc06, 0x7b6306a34627ddcf}, {0xb67f6455292cbf08, 0x1a3bc84c17b1d542},
+    {0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93}, {0x8e938662882af53e, 0x547eb47b7282ee9c},
+    {0xb23867fb2a35b28d, 0xe99e619a4f23aa43}, {0xdec681f9f4c31f31, 0x6405fa00e2ec94d4},
+    {0x8b3c113c38f9f37e, 0xde83bc408dd3dd04}, {0xae0b158b4738705e, 0x9624ab50b148d445},
+    {0xd98ddaee19068c76, 0x3badd624dd9b0957}, {0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6},
+    {0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c}, {0xd47487cc8470652b, 0x7647c3200069671f},
+    {0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073}, {0xa5fb0a17c777cf09, 0xf468107100525890},
+    {0xcf79cc9db955c2cc, 0x7182148d4066eeb4}, {0x81ac1fe293d599bf, 0xc6f14cd848405530},
+    {0xa21727db38cb002f, 0xb8ada00e5a506a7c}, {0xca9cf1d206fdc03b, 0xa6d90811f0e4851c},
+    {0xfd442e4688bd304a, 0x908f4a166d1da663}, {0x9e4a9cec15763e2e, 0x9a598e4e043287fe},
+    {0xc5dd44271ad3cdba, 0x40eff1e1853f29fd}, {0xf7549530e188c128, 0xd12bee59e68ef47c},
+    {0x9a94dd3e8cf578b9, 0x82bb74f8301958ce}, {0xc13a148e3032d6e7, 0xe36a52363c1faf01},
+    {0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1}, {0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9},
+    {0xbcb2b812db11a5de, 0x7415d448f6b6f0e7}, {0xebdf661791d60f56, 0x111b495b3464ad21},
+    {0x936b9fcebb25c995, 0xcab10dd900beec34}, {0xb84687c269ef3bfb, 0x3d5d514f40eea742},
+    {0xe65829b3046b0afa, 0x0cb4a5a3112a5112}, {0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab},
+    {0xb3f4e093db73a093, 0x59ed216765690f56}, {0xe0f218b8d25088b8, 0x306869c13ec3532c},
+    {0x8c974f7383725573, 0x1e414218c73a13fb}, {0xafbd2350644eeacf, 0xe5d1929ef90898fa},
+    {0xdbac6c247d62a583, 0xdf45f746b74abf39}, {0x894bc396ce5da772, 0x6b8bba8c328eb783},
+    {0xab9eb47c81f5114f, 0x066ea92f3f326564}, {0xd686619ba27255a2, 0xc80a537b0efefebd},
+    {0x8613fd0145877585, 0xbd06742ce95f5f36}, {0xa798fc4196e952e7, 0x2c48113823b73704},
+    {0xd17f3b51fca3a7a0, 0xf75a15862ca504c5}, {0x82ef85133de648c4, 0x9a984d73dbe722fb},
+    {0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba}, {0xcc963fee10b7d1b3, 0x318df905079926a8},
+    {0xffbbcfe994e5c61f, 0xfdf17746497f7052}, {0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633},
+    {0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0}, {0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0},
+    {0x9c1661a651213e2d, 0x06bea10ca65c084e}, {0xc31bfa0fe5698db8, 0x486e494fcff30a62},
+    {0xf3e2f893dec3f126, 0x5a89dba3c3efccfa}, {0x986ddb5c6b3a76b7, 0xf89629465a75e01c},
+    {0xbe89523386091465, 0xf6bbb397f1135823}, {0xee2ba6c0678b597f, 0x746aa07ded582e2c},
+    {0x94db483840b717ef, 0xa8c2a44eb4571cdc}, {0xba121a4650e4ddeb, 0x92f34d62616ce413},
+    {0xe896a0d7e51e1566, 0x77b020baf9c81d17}, {0x915e2486ef32cd60, 0x0ace1474dc1d122e},
+    {0xb5b5ada8aaff80b8, 0x0d819992132456ba}, {0xe3231912d5bf60e6, 0x10e1fff697ed6c69},
+    {0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1}, {0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2},
+    {0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde}, {0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b},
+    {0xad4ab7112eb3929d, 0x86c16c98d2c953c6}, {0xd89d64d57a607744, 0xe871c7bf077ba8b7},
+    {0x87625f056c7c4a8b, 0x11471cd764ad4972}, {0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf},
+    {0xd389b47879823479, 0x4aff1d108d4ec2c3}, {0x843610cb4bf160cb, 0xcedf722a585139ba},
+    {0xa54394fe1eedb8fe, 0xc2974eb4ee658828}, {0xce947a3da6a9273e, 0x733d226229feea32},
+    {0x811ccc668829b887, 0x0806357d5a3f525f}, {0xa163ff802a3426a8, 0xca07c2dcb0cf26f7},
+    {0xc9bcff6034c13052, 0xfc89b393dd02f0b5}, {0xfc2c3f3841f17c67, 0xbbac2078d443ace2},
+    {0x9d9ba7832936edc0, 0xd54b944b84aa4c0d}, {0xc5029163f384a931, 0x0a9e795e65d4df11},
+    {0xf64335bcf065d37d, 0x4d4617b5ff4a16d5}, {0x99ea0196163fa42e, 0x504bced1bf8e4e45},
+    {0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6}, {0xf07da27a82c37088, 0x5d767327bb4e5a4c},
+    {0x964e858c91ba2655, 0x3a6a07f8d510f86f}, {0xbbe226efb628afea, 0x890489f70a55368b},
+    {0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e}, {0x92c8ae6b464fc96f, 0x3b0b8bc90012929d},
+    {0xb77ada0617e3bbcb, 0x09ce6ebb40173744}, {0xe55990879ddcaabd, 0xcc420a6a101d0515},
+    {0x8f57fa54c2a9eab6, 0x9fa946824a12232d}, {0xb32df8e9f3546564, 0x47939822dc96abf9},
+    {0xdff9772470297ebd, 0x59787e2b93bc56f7}, {0x8bfbea76c619ef36, 0x57eb4edb3c55b65a},
+    {0xaefae51477a06b03, 0xede622920b6b23f1}, {0xdab99e59958885c4, 0xe95fab368e45eced},
+    {0x88b402f7fd75539b, 0x11dbcb0218ebb414}, {0xaae103b5fcd2a881, 0xd652bdc29f26a119},
+    {0xd59944a37c0752a2, 0x4be76d3346f0495f}, {0x857fcae62d8493a5, 0x6f70a4400c562ddb},
+    {0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952}, {0xd097ad07a71f26b2, 0x7e2000a41346a7a7},
+    {0x825ecc24c873782f, 0x8ed400668c0c28c8}, {0xa2f67f2dfa90563b, 0x728900802f0f32fa},
+    {0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9}, {0xfea126b7d78186bc, 0xe2f610c84987bfa8},
+    {0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9}, {0xc6ede63fa05d3143, 0x91503d1c79720dbb},
+    {0xf8a95fcf88747d94, 0x75a44c6397ce912a}, {0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba},
+    {0xc24452da229b021b, 0xfbe85badce996168}, {0xf2d56790ab41c2a2, 0xfae27299423fb9c3},
+    {0x97c560ba6b0919a5, 0xdccd879fc967d41a}, {0xbdb6b8e905cb600f, 0x5400e987bbc1c920},
+    {0xed246723473e3813, 0x290123e9aab23b68}, {0x9436c0760c86e30b, 0xf9a0b6720aaf6521},
+    {0xb94470938fa89bce, 0xf808e40e8d5b3e69}, {0xe7958cb87392c2c2, 0xb60b1d1230b20e04},
+    {0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2}, {0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3},
+    {0xe2280b6c20dd5232, 0x25c6da63c38de1b0}, {0x8d590723948a535f, 0x579c487e5a38ad0e},
+    {0xb0af48ec79ace837, 0x2d835a9df0c6d851}, {0xdcdb1b2798182244, 0xf8e431456cf88e65},
+    {0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff}, {0xac8b2d36eed2dac5, 0xe272467e3d222f3f},
+    {0xd7adf884aa879177, 0x5b0ed81dcc6abb0f}, {0x86ccbb52ea94baea, 0x98e947129fc2b4e9},
+    {0xa87fea27a539e9a5, 0x3f2398d747b36224}, {0xd29fe4b18e88640e, 0x8eec7f0d19a03aad},
+    {0x83a3eeeef9153e89, 0x1953cf68300424ac}, {0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7},
+    {0xcdb02555653131b6, 0x3792f412cb06794d}, {0x808e17555f3ebf11, 0xe2bbd88bbee40bd0},
+    {0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4}, {0xc8de047564d20a8b, 0xf245825a5a445275},
+    {0xfb158592be068d2e, 0xeed6e2f0f0d56712}, {0x9ced737bb6c4183d, 0x55464dd69685606b},
+    {0xc428d05aa4751e4c, 0xaa97e14c3c26b886}, {0xf53304714d9265df, 0xd53dd99f4b3066a8},
+    {0x993fe2c6d07b7fab, 0xe546a8038efe4029}, {0xbf8fdb78849a5f96, 0xde98520472bdd033},
+    {0xef73d256a5c0f77c, 0x963e66858f6d4440}, {0x95a8637627989aad, 0xdde7001379a44aa8},
+    {0xbb127c53b17ec159, 0x5560c018580d5d52}, {0xe9d71b689dde71af, 0xaab8f01e6e10b4a6},
+    {0x9226712162ab070d, 0xcab3961304ca70e8}, {0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22},
+    {0xe45c10c42a2b3b05, 0x8cb89a7db77c506a}, {0x8eb98a7a9a5b04e3, 0x77f3608e92adb242},
+    {0xb267ed1940f1c61c, 0x55f038b237591ed3}, {0xdf01e85f912e37a3, 0x6b6c46dec52f6688},
+    {0x8b61313bbabce2c6, 0x2323ac4b3b3da015}, {0xae397d8aa96c1b77, 0xabec975e0a0d081a},
+    {0xd9c7dced53c72255, 0x96e7bd358c904a21}, {0x881cea14545c7575, 0x7e50d64177da2e54},
+    {0xaa242499697392d2, 0xdde50bd1d5d0b9e9}, {0xd4ad2dbfc3d07787, 0x955e4ec64b44e864},
+    {0x84ec3c97da624ab4, 0xbd5af13bef0b113e}, {0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e},
+    {0xcfb11ead453994ba, 0x67de18eda5814af2}, {0x81ceb32c4b43fcf4, 0x80eacf948770ced7},
+    {0xa2425ff75e14fc31, 0xa1258379a94d028d}, {0xcad2f7f5359a3b3e, 0x096ee45813a04330},
+    {0xfd87b5f28300ca0d, 0x8bca9d6e188853fc}, {0x9e74d1b791e07e48, 0x775ea264cf55347e},
+    {0xc612062576589dda, 0x95364afe032a819e}, {0xf79687aed3eec551, 0x3a83ddbd83f52205},
+    {0x9abe14cd44753b52, 0xc4926a9672793543}, {0xc16d9a0095928a27, 0x75b7053c0f178294},
+    {0xf1c90080baf72cb1, 0x5324c68b12dd6339}, {0x971da05074da7bee, 0xd3f6fc16ebca5e04},
+    {0xbce5086492111aea, 0x88f4bb1ca6bcf585}, {0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6},
+    {0x9392ee8e921d5d07, 0x3aff322e62439fd0}, {0xb877aa3236a4b449, 0x09befeb9fad487c3},
+    {0xe69594bec44de15b, 0x4c2ebe687989a9b4}, {0x901d7cf73ab0acd9, 0x0f9d37014bf60a11},
+    {0xb424dc35095cd80f, 0x538484c19ef38c95}, {0xe12e13424bb40e13, 0x2865a5f206b06fba},
+    {0x8cbccc096f5088cb, 0xf93f87b7442e45d4}, {0xafebff0bcb24aafe, 0xf78f69a51539d749},
+    {0xdbe6fecebdedd5be, 0xb573440e5a884d1c}, {0x89705f4136b4a597, 0x31680a88f8953031},
+    {0xabcc77118461cefc, 0xfdc20d2b36ba7c3e}, {0xd6bf94d5e57a42bc, 0x3d32907604691b4d},
+    {0x8637bd05af6c69b5, 0xa63f9a49c2c1b110}, {0xa7c5ac471b478423, 0x0fcf80dc33721d54},
+    {0xd1b71758e219652b, 0xd3c36113404ea4a9}, {0x83126e978d4fdf3b, 0x645a1cac083126ea},
+    {0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4}, {0xcccccccccccccccc, 0xcccccccccccccccd},
+    {0x8000000000000000, 0x0000000000000000}, {0xa000000000000000, 0x0000000000000000},
+    {0xc800000000000000, 0x0000000000000000}, {0xfa00000000000000, 0x0000000000000000},
+    {0x9c40000000000000, 0x0000000000000000}, {0xc350000000000000, 0x0000000000000000},
+    {0xf424000000000000, 0x0000000000000000}, {0x9896800000000000, 0x0000000000000000},
+    {0xbebc200000000000, 0x0000000000000000}, {0xee6b280000000000, 0x0000000000000000},
+    {0x9502f90000000000, 0x0000000000000000}, {0xba43b74000000000, 0x0000000000000000},
+    {0xe8d4a51000000000, 0x0000000000000000}, {0x9184e72a00000000, 0x0000000000000000},
+    {0xb5e620f480000000, 0x0000000000000000}, {0xe35fa931a0000000, 0x0000000000000000},
+    {0x8e1bc9bf04000000, 0x0000000000000000}, {0xb1a2bc2ec5000000, 0x0000000000000000},
+    {0xde0b6b3a76400000, 0x0000000000000000}, {0x8ac7230489e80000, 0x0000000000000000},
+    {0xad78ebc5ac620000, 0x0000000000000000}, {0xd8d726b7177a8000, 0x0000000000000000},
+    {0x878678326eac9000, 0x0000000000000000}, {0xa968163f0a57b400, 0x0000000000000000},
+    {0xd3c21bcecceda100, 0x0000000000000000}, {0x84595161401484a0, 0x0000000000000000},
+    {0xa56fa5b99019a5c8, 0x0000000000000000}, {0xcecb8f27f4200f3a, 0x0000000000000000},
+    {0x813f3978f8940984, 0x4000000000000000}, {0xa18f07d736b90be5, 0x5000000000000000},
+    {0xc9f2c9cd04674ede, 0xa400000000000000}, {0xfc6f7c4045812296, 0x4d00000000000000},
+    {0x9dc5ada82b70b59d, 0xf020000000000000}, {0xc5371912364ce305, 0x6c28000000000000},
+    {0xf684df56c3e01bc6, 0xc732000000000000}, {0x9a130b963a6c115c, 0x3c7f400000000000},
+    {0xc097ce7bc90715b3, 0x4b9f100000000000}, {0xf0bdc21abb48db20, 0x1e86d40000000000},
+    {0x96769950b50d88f4, 0x1314448000000000}, {0xbc143fa4e250eb31, 0x17d955a000000000},
+    {0xeb194f8e1ae525fd, 0x5dcfab0800000000}, {0x92efd1b8d0cf37be, 0x5aa1cae500000000},
+    {0xb7abc627050305ad, 0xf14a3d9e40000000}, {0xe596b7b0c643c719, 0x6d9ccd05d0000000},
+    {0x8f7e32ce7bea5c6f, 0xe4820023a2000000}, {0xb35dbf821ae4f38b, 0xdda2802c8a800000},
+    {0xe0352f62a19e306e, 0xd50b2037ad200000}, {0x8c213d9da502de45, 0x4526f422cc340000},
+    {0xaf298d050e4395d6, 0x9670b12b7f410000}, {0xdaf3f04651d47b4c, 0x3c0cdd765f114000},
+    {0x88d8762bf324cd0f, 0xa5880a69fb6ac800}, {0xab0e93b6efee0053, 0x8eea0d047a457a00},
+    {0xd5d238a4abe98068, 0x72a4904598d6d880}, {0x85a36366eb71f041, 0x47a6da2b7f864750},
+    {0xa70c3c40a64e6c51, 0x999090b65f67d924}, {0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d},
+    {0x82818f1281ed449f, 0xbff8f10e7a8921a4}, {0xa321f2d7226895c7, 0xaff72d52192b6a0d},
+    {0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490}, {0xfee50b7025c36a08, 0x02f236d04753d5b4},
+    {0x9f4f2726179a2245, 0x01d762422c946590}, {0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5},
+    {0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2}, {0x9b934c3b330c8577, 0x63cc55f49f88eb2f},
+    {0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb}, {0xf316271c7fc3908a, 0x8bef464e3945ef7a},
+    {0x97edd871cfda3a56, 0x97758bf0e3cbb5ac}, {0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317},
+    {0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd}, {0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a},
+    {0xb975d6b6ee39e436, 0xb3e2fd538e122b44}, {0xe7d34c64a9c85d44, 0x60dbbca87196b616},
+    {0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd}, {0xb51d13aea4a488dd, 0x6babab6398bdbe41},
+    {0xe264589a4dcdab14, 0xc696963c7eed2dd1}, {0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2},
+    {0xb0de65388cc8ada8, 0x3b25a55f43294bcb}, {0xdd15fe86affad912, 0x49ef0eb713f39ebe},
+    {0x8a2dbf142dfcc7ab, 0x6e3569326c784337}, {0xacb92ed9397bf996, 0x49c2c37f07965404},
+    {0xd7e77a8f87daf7fb, 0xdc33745ec97be906}, {0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3},
+    {0xa8acd7c0222311bc, 0xc40832ea0d68ce0c}, {0xd2d80db02aabd62b, 0xf50a3fa490c30190},
+    {0x83c7088e1aab65db, 0x792667c6da79e0fa}, {0xa4b8cab1a1563f52, 0x577001b891185938},
+    {0xcde6fd5e09abcf26, 0xed4c0226b55e6f86}, {0x80b05e5ac60b6178, 0x544f8158315b05b4},
+    {0xa0dc75f1778e39d6, 0x696361ae3db1c721}, {0xc913936dd571c84c, 0x03bc3a19cd1e38e9},
+    {0xfb5878494ace3a5f, 0x04ab48a04065c723}, {0x9d174b2dcec0e47b, 0x62eb0d64283f9c76},
+    {0xc45d1df942711d9a, 0x3ba5d0bd324f8394}, {0xf5746577930d6500, 0xca8f44ec7ee36479},
+    {0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb}, {0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e},
+    {0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e}, {0x95d04aee3b80ece5, 0xbba1f1d158724a12},
+    {0xbb445da9ca61281f, 0x2a8a6e45ae8edc97}, {0xea1575143cf97226, 0xf52d09d71a3293bd},
+    {0x924d692ca61be758, 0x593c2626705f9c56}, {0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c},
+    {0xe498f455c38b997a, 0x0b6dfb9c0f956447}, {0x8edf98b59a373fec, 0x4724bd4189bd5eac},
+    {0xb2977ee300c50fe7, 0x58edec91ec2cb657}, {0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed},
+    {0x8b865b215899f46c, 0xbd79e0d20082ee74}, {0xae67f1e9aec07187, 0xecd8590680a3aa11},
+    {0xda01ee641a708de9, 0xe80e6f4820cc9495}, {0x884134fe908658b2, 0x3109058d147fdcdd},
+    {0xaa51823e34a7eede, 0xbd4b46f0599fd415}, {0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a},
+    {0x850fadc09923329e, 0x03e2cf6bc604ddb0}, {0xa6539930bf6bff45, 0x84db8346b786151c},
+    {0xcfe87f7cef46ff16, 0xe612641865679a63}, {0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e},
+    {0xa26da3999aef7749, 0xe3be5e330f38f09d}, {0xcb090c8001ab551c, 0x5cadf5bfd3072cc5},
+    {0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6}, {0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa},
+    {0xc646d63501a1511d, 0xb281e1fd541501b8}, {0xf7d88bc24209a565, 0x1f225a7ca91a4226},
+    {0x9ae757596946075f, 0x3375788de9b06958}, {0xc1a12d2fc3978937, 0x0052d6b1641c83ae},
+    {0xf209787bb47d6b84, 0xc0678c5dbd23a49a}, {0x9745eb4d50ce6332, 0xf840b7ba963646e0},
+    {0xbd176620a501fbff, 0xb650e5a93bc3d898}, {0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe},
+    {0x93ba47c980e98cdf, 0xc66f336c36b10137}, {0xb8a8d9bbe123f017, 0xb80b0047445d4184},
+    {0xe6d3102ad96cec1d, 0xa60dc059157491e5}, {0x9043ea1ac7e41392, 0x87c89837ad68db2f},
+    {0xb454e4a179dd1877, 0x29babe4598c311fb}, {0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a},
+    {0x8ce2529e2734bb1d, 0x1899e4a65f58660c}, {0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f},
+    {0xdc21a1171d42645d, 0x76707543f4fa1f73}, {0x899504ae72497eba, 0x6a06494a791c53a8},
+    {0xabfa45da0edbde69, 0x0487db9d17636892}, {0xd6f8d7509292d603, 0x45a9d2845d3c42b6},
+    {0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2}, {0xa7f26836f282b732, 0x8e6cac7768d7141e},
+    {0xd1ef0244af2364ff, 0x3207d795430cd926}, {0x8335616aed761f1f, 0x7f44e6bd49e807b8},
+    {0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6}, {0xcd036837130890a1, 0x36dba887c37a8c0f},
+    {0x802221226be55a64, 0xc2494954da2c9789}, {0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c},
+    {0xc83553c5c8965d3d, 0x6f92829494e5acc7}, {0xfa42a8b73abbf48c, 0xcb772339ba1f17f9},
+    {0x9c69a97284b578d7, 0xff2a760414536efb}, {0xc38413cf25e2d70d, 0xfef5138519684aba},
+    {0xf46518c2ef5b8cd1, 0x7eb258665fc25d69}, {0x98bf2f79d5993802, 0xef2f773ffbd97a61},
+    {0xbeeefb584aff8603, 0xaafb550ffacfd8fa}, {0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38},
+    {0x952ab45cfa97a0b2, 0xdd945a747bf26183}, {0xba756174393d88df, 0x94f971119aeef9e4},
+    {0xe912b9d1478ceb17, 0x7a37cd5601aab85d}, {0x91abb422ccb812ee, 0xac62e055c10ab33a},
+    {0xb616a12b7fe617aa, 0x577b986b314d6009}, {0xe39c49765fdf9d94, 0xed5a7e85fda0b80b},
+    {0x8e41ade9fbebc27d, 0x14588f13be847307}, {0xb1d219647ae6b31c, 0x596eb2d8ae258fc8},
+    {0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb}, {0x8aec23d680043bee, 0x25de7bb9480d5854},
+    {0xada72ccc20054ae9, 0xaf561aa79a10ae6a}, {0xd910f7ff28069da4, 0x1b2ba1518094da04},
+    {0x87aa9aff79042286, 0x90fb44d2f05d0842}, {0xa99541bf57452b28, 0x353a1607ac744a53},
+    {0xd3fa922f2d1675f2, 0x42889b8997915ce8}, {0x847c9b5d7c2e09b7, 0x69956135febada11},
+    {0xa59bc234db398c25, 0x43fab9837e699095}, {0xcf02b2c21207ef2e, 0x94f967e45e03f4bb},
+    {0x8161afb94b44f57d, 0x1d1be0eebac278f5}, {0xa1ba1ba79e1632dc, 0x6462d92a69731732},
+    {0xca28a291859bbf93, 0x7d7b8f7503cfdcfe}, {0xfcb2cb35e702af78, 0x5cda735244c3d43e},
+    {0x9defbf01b061adab, 0x3a0888136afa64a7}, {0xc56baec21c7a1916, 0x088aaa1845b8fdd0},
+    {0xf6c69a72a3989f5b, 0x8aad549e57273d45}, {0x9a3c2087a63f6399, 0x36ac54e2f678864b},
+    {0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd}, {0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5},
+    {0x969eb7c47859e743, 0x9f644ae5a4b1b325}, {0xbc4665b596706114, 0x873d5d9f0dde1fee},
+    {0xeb57ff22fc0c7959, 0xa90cb506d155a7ea}, {0x9316ff75dd87cbd8, 0x09a7f12442d588f2},
+    {0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f}, {0xe5d3ef282a242e81, 0x8f1668c8a86da5fa},
+    {0x8fa475791a569d10, 0xf96e017d694487bc}, {0xb38d92d760ec4455, 0x37c981dcc395a9ac},
+    {0xe070f78d3927556a, 0x85bbe253f47b1417}, {0x8c469ab843b89562, 0x93956d7478ccec8e},
+    {0xaf58416654a6babb, 0x387ac8d1970027b2}, {0xdb2e51bfe9d0696a, 0x06997b05fcc0319e},
+    {0x88fcf317f22241e2, 0x441fece3bdf81f03}, {0xab3c2fddeeaad25a, 0xd527e81cad7626c3},
+    {0xd60b3bd56a5586f1, 0x8a71e223d8d3b074}, {0x85c7056562757456, 0xf6872d5667844e49},
+    {0xa738c6bebb12d16c, 0xb428f8ac016561db}, {0xd106f86e69d785c7, 0xe13336d701beba52},
+    {0x82a45b450226b39c, 0xecc0024661173473}, {0xa34d721642b06084, 0x27f002d7f95d0190},
+    {0xcc20ce9bd35c78a5, 0x31ec038df7b441f4}, {0xff290242c83396ce, 0x7e67047175a15271},
+    {0x9f79a169bd203e41, 0x0f0062c6e984d386}, {0xc75809c42c684dd1, 0x52c07b78a3e60868},
+    {0xf92e0c3537826145, 0xa7709a56ccdf8a82}, {0x9bbcc7a142b17ccb, 0x88a66076400bb691},
+    {0xc2abf989935ddbfe, 0x6acff893d00ea435}, {0xf356f7ebf83552fe, 0x0583f6b8c4124d43},
+    {0x98165af37b2153de, 0xc3727a337a8b704a}, {0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c},
+    {0xeda2ee1c7064130c, 0x1162def06f79df73}, {0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8},
+    {0xb9a74a0637ce2ee1, 0x6d953e2bd7173692}, {0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437},
+    {0x910ab1d4db9914a0, 0x1d9c9892400a22a2}, {0xb54d5e4a127f59c8, 0x2503beb6d00cab4b},
+    {0xe2a0b5dc971f303a, 0x2e44ae64840fd61d}, {0x8da471a9de737e24, 0x5ceaecfed289e5d2},
+    {0xb10d8e1456105dad, 0x7425a83e872c5f47}, {0xdd50f1996b947518, 0xd12f124e28f77719},
+    {0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f}, {0xace73cbfdc0bfb7b, 0x636cc64d1001550b},
+    {0xd8210befd30efa5a, 0x3c47f7e05401aa4e}, {0x8714a775e3e95c78, 0x65acfaec34810a71},
+    {0xa8d9d1535ce3b396, 0x7f1839a741a14d0d}, {0xd31045a8341ca07c, 0x1ede48111209a050},
+    {0x83ea2b892091e44d, 0x934aed0aab460432}, {0xa4e4b66b68b65d60, 0xf81da84d5617853f},
+    {0xce1de40642e3f4b9, 0x36251260ab9d668e}, {0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019},
+    {0xa1075a24e4421730, 0xb24cf65b8612f81f}, {0xc94930ae1d529cfc, 0xdee033f26797b627},
+    {0xfb9b7cd9a4a7443c, 0x169840ef017da3b1}, {0x9d412e0806e88aa5, 0x8e1f289560ee864e},
+    {0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2}, {0xf5b5d7ec8acb58a2, 0xae10af696774b1db},
+    {0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29}, {0xbff610b0cc6edd3f, 0x17fd090a58d32af3},
+    {0xeff394dcff8a948e, 0xddfc4b4cef07f5b0}, {0x95f83d0a1fb69cd9, 0x4abdaf101564f98e},
+    {0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1}, {0xea53df5fd18d5513, 0x84c86189216dc5ed},
+    {0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4}, {0xb7118682dbb66a77, 0x3fbc8c33221dc2a1},
+    {0xe4d5e82392a40515, 0x0fabaf3feaa5334a}, {0x8f05b1163ba6832d, 0x29cb4d87f2a7400e},
+    {0xb2c71d5bca9023f8, 0x743e20e9ef511012}, {0xdf78e4b2bd342cf6, 0x914da9246b255416},
+    {0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e}, {0xae9672aba3d0c320, 0xa184ac2473b529b1},
+    {0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e}, {0x8865899617fb1871, 0x7e2fa67c7a658892},
+    {0xaa7eebfb9df9de8d, 0xddbb901b98feeab7}, {0xd51ea6fa85785631, 0x552a74227f3ea565},
+    {0x8533285c936b35de, 0xd53a88958f87275f}, {0xa67ff273b8460356, 0x8a892abaf368f137},
+    {0xd01fef10a657842c, 0x2d2b7569b0432d85}, {0x8213f56a67f6b29b, 0x9c3b29620e29fc73},
+    {0xa298f2c501f45f42, 0x8349f3ba91b47b8f}, {0xcb3f2f7642717713, 0x241c70a936219a73},
+    {0xfe0efb53d30dd4d7, 0xed238cd383aa0110}, {0x9ec95d1463e8a506, 0xf4363804324a40aa},
+    {0xc67bb4597ce2ce48, 0xb143c6053edcd0d5}, {0xf81aa16fdc1b81da, 0xdd94b7868e94050a},
+    {0x9b10a4e5e9913128, 0xca7cf2b4191c8326}, {0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0},
+    {0xf24a01a73cf2dccf, 0xbc633b39673c8cec}, {0x976e41088617ca01, 0xd5be0503e085d813},
+    {0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18}, {0xec9c459d51852ba2, 0xddf8e7d60ed1219e},
+    {0x93e1ab8252f33b45, 0xcabb90e5c942b503}, {0xb8da1662e7b00a17, 0x3d6a751f3b936243},
+    {0xe7109bfba19c0c9d, 0x0cc512670a783ad4}, {0x906a617d450187e2, 0x27fb2b80668b24c5},
+    {0xb484f9dc9641e9da, 0xb1f9f660802dedf6}, {0xe1a63853bbd26451, 0x5e7873f8a0396973},
+    {0x8d07e33455637eb2, 0xdb0b487b6423e1e8}, {0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62},
+    {0xdc5c5301c56b75f7, 0x7641a140cc7810fb}, {0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d},
+    {0xac2820d9623bf429, 0x546345fa9fbdcd44}, {0xd732290fbacaf133, 0xa97c177947ad4095},
+    {0x867f59a9d4bed6c0, 0x49ed8eabcccc485d}, {0xa81f301449ee8c70, 0x5c68f256bfff5a74},
+    {0xd226fc195c6a2f8c, 0x73832eec6fff3111}, {0x83585d8fd9c25db7, 0xc831fd53c5ff7eab},
+    {0xa42e74f3d032f525, 0xba3e7ca8b77f5e55}, {0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb},
+    {0x80444b5e7aa7cf85, 0x7980d163cf5b81b3}, {0xa0555e361951c366, 0xd7e105bcc332621f},
+    {0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7}, {0xfa856334878fc150, 0xb14f98f6f0feb951},
+    {0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3}, {0xc3b8358109e84f07, 0x0a862f80ec4700c8},
+    {0xf4a642e14c6262c8, 0xcd27bb612758c0fa}, {0x98e7e9cccfbd7dbd, 0x8038d51cb897789c},
+    {0xbf21e44003acdd2c, 0xe0470a63e6bd56c3}, {0xeeea5d5004981478, 0x1858ccfce06cac74},
+    {0x95527a5202df0ccb, 0x0f37801e0c43ebc8}, {0xbaa718e68396cffd, 0xd30560258f54e6ba},
+    {0xe950df20247c83fd, 0x47c6b82ef32a2069}, {0x91d28b7416cdd27e, 0x4cdc331d57fa5441},
+    {0xb6472e511c81471d, 0xe0133fe4adf8e952}, {0xe3d8f9e563a198e5, 0x58180fddd97723a6},
+    {0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648},
+};
+
+static read_only f64 _str_pow10_exact[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+internal f64 _str_f64_from_bits(u64 bits) {
+    f64 f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+/* Returns the bits of w * 10^q rounded to nearest even, w != 0 */
+internal u64 _str_eisel_lemire(u64 w, s64 q) {
+    if (q < STR_F64_MIN_POW10) {
+        return 0;
+    }
+    if (q > STR_F64_MAX_POW10) {
+        return 0x7FFull << 52;
+    }
+    s32 lz = 63 - (s32) bit_scan_reverse_u64(w);
+    w <<= lz;
+
+    /* 55 bits are needed, only look at the low half of 5^q if the top 9 could carry */
+    const u64 *pow5 = _str_pow5_128[q - STR_F64_MIN_POW10];
+    u64 hi;
+    u64 lo = mul_u64_wide(w, pow5[0], &hi);
+    if ((hi & 0x1FF) == 0x1FF) {
+        u64 hi2;
+        mul_u64_wide(w, pow5[1], &hi2);
+        lo += hi2;
+        hi += (lo < hi2);
+    }
+
+    s32 upper = (s32) (hi >> 63);
+    s32 shift = upper + 9;
+    u64 mantissa = hi >> shift;
+    /* floor(log2(10^q)) + 63 is (217706*q >> 16) + 63 for q in range */
+    s64 power2 = ((217706*q) >> 16) + 63 + upper - lz + 1023;
+
+    if (power2 <= 0) { /* Subnormal */
+        if (1 - power2 >= 64) {
+            return 0;
+        }
+        mantissa >>= 1 - power2;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        /* Rounding up to 2^52 makes it the smallest normal, which is the same bits */
+        return mantissa;
+    }
+
+    /* Exactly halfway happens only for small q, round to even there instead of up */
+    if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == hi) {
+        mantissa &= ~1ull;
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (2ull << 52)) {
+        mantissa = 1ull << 52;
+        power2++;
+    }
+    if (power2 >= 0x7FF) {
+        return 0x7FFull << 52;
+    }
+    return (mantissa & ((1ull << 52) - 1)) | ((u64) power2 << 52);
+}
+
+/* Exact decimal: digits d[0..nd) with the point before d[dp], ie 0.d * 10^dp. Doubled or
+   halved a few bits at a time until it is in [1/2, 1), then the 53 bits are read off. 800
+   digits are enough to round any double exactly, digits dropped past that set trunc. */
+#define STR_DECIMAL_DIGITS 800
+#define STR_DECIMAL_MAX_SHIFT 60
+struct _StrDecimal {
+    s32 nd;
+    s32 dp;
+    s32 trunc;
+    u8 d[STR_DECIMAL_DIGITS];
+};
+
+internal void _StrDecimal_trim(struct _StrDecimal *a) {
+    while (a->nd > 0 && a->d[a->nd-1] == 0) {
+        a->nd--;
+    }
+    if (a->nd == 0) {
+        a->dp = 0;
+    }
+}
+
+internal void _StrDecimal_shift_left(struct _StrDecimal *a, s32 k) {
+    /* Digits are written right to left into tmp, then moved down */
+    u8 tmp[STR_DECIMAL_DIGITS + 20];
+    s32 w = ARRAY_LENGTH(tmp);
+    u64 n = 0;
+    for (s32 r = a->nd - 1; r >= 0; r--) {
+        n += (u64) a->d[r] << k;
+        tmp[--w] = (u8) (n % 10);
+        n /= 10;
+    }
+    while (n > 0) {
+        tmp[--w] = (u8) (n % 10);
+        n /= 10;
+    }
+    s32 nd = (s32) ARRAY_LENGTH(tmp) - w;
+    a->dp += nd - a->nd;
+    if (nd > STR_DECIMAL_DIGITS) {
+        for (s32 i = STR_DECIMAL_DIGITS; i < nd; i++) {
+            a->trunc |= tmp[w + i] != 0;
+        }
+        nd = STR_DECIMAL_DIGITS;
+    }
+    memcpy(a->d, tmp + w, nd);
+    a->nd = nd;
+    _StrDecimal_trim(a);
+}
+
+internal void _StrDecimal_shift_right(struct _StrDecimal *a, s32 k) {
+    s32 r = 0, w = 0;
+    u64 n = 0;
+    for (; (n >> k) == 0; r++) {
+        if (r >= a->nd) {
+            if (n == 0) {
+                a->nd = 0;
+                return;
+            }
+            while ((n >> k) == 0) {
+                n *= 10;
+                r++;
+            }
+            break;
+        }
+        n = n*10 + a->d[r];
+    }
+    a->dp -= r - 1;
+    u64 mask = (1ull << k) - 1;
+    for (; r < a->nd; r++) {
+        a->d[w++] = (u8) (n >> k);
+        n = (n & mask)*10 + a->d[r];
+    }
+    while (n > 0) {
+        u8 digit = (u8) (n >> k);
+        if (w < STR_DECIMAL_DIGITS) {
+            a->d[w++] = digit;
+        } else if (digit > 0) {
+            a->trunc = 1;
+        }
+        n = (n & mask)*10;
+    }
+    a->nd = w;
+    _StrDecimal_trim(a);
+}
+
+internal void _StrDecimal_shift(struct _StrDecimal *a, s32 k) {
+    if (a->nd == 0) {
+        return;
+    }
+    for (; k > STR_DECIMAL_MAX_SHIFT; k -= STR_DECIMAL_MAX_SHIFT) {
+        _StrDecimal_shift_left(a, STR_DECIMAL_MAX_SHIFT);
+    }
+    for (; k < -STR_DECIMAL_MAX_SHIFT; k += STR_DECIMAL_MAX_SHIFT) {
+        _StrDecimal_shift_right(a, STR_DECIMAL_MAX_SHIFT);
+    }
+    if (k > 0) {
+        _StrDecimal_shift_left(a, k);
+    } else if (k < 0) {
+        _StrDecimal_shift_right(a, -k);
+    }
+}
+
+/* Integer part of a, rounded to nearest even */
+internal u64 _StrDecimal_round(struct _StrDecimal *a) {
+    s32 i = 0;
+    u64 n = 0;
+    for (; i < a->dp && i < a->nd; i++) {
+        n = n*10 + a->d[i];
+    }
+    for (; i < a->dp; i++) {
+        n *= 10;
+    }
+    s32 up = 0;
+    if (a->dp >= 0 && a->dp < a->nd) {
+        if (a->d[a->dp] == 5 && a->dp + 1 == a->nd) {
+            up = a->trunc || (a->dp > 0 && (a->d[a->dp-1] & 1));
+        } else {
+            up = a->d[a->dp] >= 5;
+        }
+    }
+    return n + up;
+}
+
+/* Returns the bits of the decimal digits in s, which is a mantissa as validated by
+   str_to_f64 (digits with at most one dot), times 10^exp10 */
+internal u64 _str_decimal_to_bits(str s, s64 exp10) {
+    static read_only s32 pow2_for_pow10[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    struct _StrDecimal a;
+    a.nd = 0;
+    a.dp = 0;
+    a.trunc = 0;
+    s32 seen_dot = 0;
+    str_iter(s, i, c) {
+        if (c == '.') {
+            seen_dot = 1;
+            continue;
+        }
+        u8 digit = (u8) (c - '0');
+        if (digit == 0 && a.nd == 0) { /* Leading zero */
+            a.dp -= seen_dot;
+            continue;
+        }
+        if (!seen_dot) {
+            a.dp++;
+        }
+        if (a.nd < STR_DECIMAL_DIGITS) {
+            a.d[a.nd++] = digit;
+        } else if (digit) {
+            a.trunc = 1;
+        }
+    }
+    _StrDecimal_trim(&a);
+    if (a.nd == 0) {
+        return 0;
+    }
+    exp10 += a.dp;
+    if (exp10 > 310) {
+        return 0x7FFull << 52;
+    }
+    if (exp10 < -330) {
+        return 0;
+    }
+    a.dp = (s32) exp10;
+
+    s32 exp = 0;
+    while (a.dp > 0) {
+        s32 n = (a.dp >= (s32) ARRAY_LENGTH(pow2_for_pow10))? 27 : pow2_for_pow10[a.dp];
+        _StrDecimal_shift(&a, -n);
+        exp += n;
+    }
+    while (a.dp < 0 || (a.dp == 0 && a.d[0] < 5)) {
+        s32 n = (-a.dp >= (s32) ARRAY_LENGTH(pow2_for_pow10))? 27 : pow2_for_pow10[-a.dp];
+        _StrDecimal_shift(&a, n);
+        exp -= n;
+    }
+    /* a is in [1/2, 1), so the value is in [1, 2) * 2^exp */
+    exp--;
+    if (exp < -1022) {
+        _StrDecimal_shift(&a, exp + 1022);
+        exp = -1022;
+    }
+    if (exp + 1023 >= 0x7FF) {
+        return 0x7FFull << 52;
+    }
+    _StrDecimal_shift(&a, 53);
+    u64 mantissa = _StrDecimal_round(&a);
+    if (mantissa == (2ull << 52)) {
+        mantissa >>= 1;
+        exp++;
+        if (exp + 1023 >= 0x7FF) {
+            return 0x7FFull << 52;
+        }
+    }
+    if (!(mantissa & (1ull << 52))) { /* Subnormal */
+        exp = -1023;
+    }
+    return (mantissa & ((1ull << 52) - 1)) | ((u64) (exp + 1023) << 52);
+}
+
+/* Returns the bits of m * 2^e2 rounded to nearest even, sticky is set if there were more bits
+   below m */
+internal u64 _str_binary_to_bits(u64 m, s64 e2, s32 sticky) {
+    if (m == 0) {
+        return 0;
+    }
+    s32 lz = 63 - (s32) bit_scan_reverse_u64(m);
+    m <<= lz;
+    e2 -= lz;
+    s64 biased = e2 + 63 + 1023;
+    if (biased >= 0x7FF) {
+        return 0x7FFull << 52;
+    }
+    if (biased <= -53) {
+        return 0;
+    }
+    s32 shift = (biased > 0)? 11 : (s32) (12 - biased);
+    u64 kept = (shift < 64)? m >> shift : 0;
+    u64 rest = (shift < 64)? m & ((1ull << shift) - 1) : m;
+    u64 half = 1ull << (shift - 1);
+    kept += (rest > half) || (rest == half && (sticky || (kept & 1)));
+    if (biased <= 0) {
+        return kept; /* Subnormal, carrying into bit 52 makes the smallest normal */
+    }
+    if (kept == (1ull << 53)) {
+        kept >>= 1;
+        biased++;
+        if (biased >= 0x7FF) {
+            return 0x7FFull << 52;
+        }
+    }
+    return (kept & ((1ull << 52) - 1)) | ((u64) biased << 52);
+}
+
 f64 str_to_f64(str s, s32 *failure) {
-    s32 i;
+    s64 i;
     str p = str_trim_whitespace(s);
+    if (failure) *failure = 1;
+    if (p.len == 0) {
+        return 0.0;
+    }
 
-    s32 sign = 1;
+    u64 sign = 0;
     if (*p.str == '+' || *p.str == '-') {
-        sign = (*p.str == '-')? -1 : 1;
+        sign = (*p.str == '-')? 1ull << 63 : 0;
         p.str += 1; p.len -= 1;
     }
 
@@ -500,16 +1630,15 @@ f64 str_to_f64(str s, s32 *failure) {
                 break;
             }
         }
-        if (i == 3 || i == 8) { 
+        if (i == 3 || i == 8) {
             if (failure) *failure = 0;
-            return sign * INFINITY;
+            return sign? -INFINITY : INFINITY;
         } else if (i > 0) {
-            if (failure) *failure = 1;
             return 0.0;
         }
     }
 
-    { // match nan 
+    { // match nan
         for (i = 0; i < MIN(3, p.len); i++) {
             if ((p.str[i]|32) != "nan"[i]) {
                 break;
@@ -519,225 +1648,735 @@ f64 str_to_f64(str s, s32 *failure) {
             if (failure) *failure = 0;
             return NAN;
         } else if (i > 0) {
-            return 1;
+            return 0.0;
         }
     }
 
-    s32 is_hex = 0;
-    if (p.str[0] == '0' && p.str[1] == 'x') { // Hex
-        is_hex = 1;
-        p.str += 2; p.len -= 2;
-    }
-
-    { // skip leading zeros
-        for (i = 0; i < p.len; i++) {
-            if (p.str[i] != '0') {
+    i = 0;
+    u64 bits;
+    if (p.len > 2 && p.str[0] == '0' && (p.str[1]|32) == 'x') { // Hex, exponent is a power of 2
+        i = 2;
+        u64 m = 0;
+        s64 e2 = 0;
+        s32 sticky = 0, got_digit = 0, got_dot = 0;
+        for (; i < p.len; i++) {
+            if (p.str[i] == '.' && !got_dot) {
+                got_dot = 1;
+                continue;
+            }
+            u8 digit = (u8) (p.str[i] - '0');
+            if (digit >= 10) {
+                digit = (u8) ((p.str[i]|32) - 'a');
+                digit = (digit < 6)? digit + 10 : 16;
+            }
+            if (digit >= 16) {
                 break;
             }
+            got_digit = 1;
+            if ((m >> 60) == 0) {
+                m = 16*m + digit;
+                e2 -= 4*got_dot;
+            } else {
+                sticky |= (digit != 0);
+                e2 += 4*!got_dot;
+            }
         }
-        p.str += i; p.len -= i;
-    }
-
-    s32 got_frac = 0;
-    s32 exp_offset = 0;
-    if (*p.str == '.') { // dot before digits, eg 0.505
-        got_frac = 1;
-        p.str += 1; p.len -= 1;
-
-        { // handle zeros after dot, eg 0.000000000505
-            for (i = 0; i < p.len; i++) {
-                if (p.str[i] != '0') {
-                    break;
-                }
+        if (!got_digit) {
+            return 0.0;
+        }
+        if (i < p.len && (p.str[i]|32) == 'p') {
+            s64 exp = 0;
+            s32 exp_sign = 1, got_exp = 0;
+            i++;
+            if (i < p.len && (p.str[i] == '+' || p.str[i] == '-')) {
+                exp_sign = (p.str[i] == '-')? -1 : 1;
+                i++;
+            }
+            for (; i < p.len && (u8) (p.str[i] - '0') < 10; i++) {
+                got_exp = 1;
+                if (exp < 100000) exp = 10*exp + (p.str[i] - '0');
             }
-            p.str += i; p.len -= i;
-            exp_offset = -i;
+            if (!got_exp) {
+                return 0.0;
+            }
+            e2 += exp_sign*exp;
         }
-    }
-
-    u64 mantissa = 0;
-    if (p.len > 0) {
-        if (is_hex) {
-            s32 len = MIN((s32)p.len, 19); // NOTE(lf): 19 = floor(log10(2^64))
-            s32 zeros = 0;
-
-            { // Catch garbage strings
-                u8 digit = p.str[i] - '0';
-                if (digit >= 10) digit = 10 + (p.str[i]|32)-'a';
-                if (digit > 16) {
-                    if (failure) *failure = 1;
-                    return 0.0;
-                }
+        bits = _str_binary_to_bits(m, e2, sticky);
+    } else {
+        /* Up to 19 significant digits go in w, so another digit fits while w < 10^18. q counts
+           the digits left out of it. Runs of 8 are taken at once while w < 10^11. */
+        u64 w = 0, v = 0;
+        s64 q = 0;
+        s32 truncated = 0, got_digit = 0;
+        while (w < 100000000000ull && p.len - i >= 8 && _str_parse_digits8(p.str + i, 10, &v) == 8) {
+            w = 100000000*w + v;
+            got_digit = 1;
+            i += 8;
+        }
+        for (; i < p.len && (u8) (p.str[i] - '0') < 10; i++) {
+            u8 digit = (u8) (p.str[i] - '0');
+            got_digit = 1;
+            if (w < 1000000000000000000ull) {
+                w = 10*w + digit;
+            } else {
+                q++;
+                truncated |= (digit != 0);
             }
-                
-            for (i = 0; i < len; i++) {
-                if (p.str[i] == '.') {
-                    if (got_frac) {
-                        p.len = i;
-                        break;
-                    }
-                    got_frac = 1;
-                    
-                    while (zeros > 0) {
-                        mantissa *= 16;
-                        zeros--;
-                    }
-
-                    exp_offset = 0; 
-                    continue;
-                }
-            
-                u8 digit = p.str[i] - '0';
-                if (digit >= 10) digit = 10 + (p.str[i]|32)-'a';
-                if (digit < 16) {
-                    if (digit > 0) {
-                        if (got_frac) {
-                            exp_offset -= 1 + zeros;
-                        }
-                        while (zeros > 0) {
-                            mantissa *= 16;
-                            zeros--;
-                        }
-                        mantissa = mantissa*16 + digit; 
-                    } else {
-                        zeros++;
-                    }
+        }
+        if (i < p.len && p.str[i] == '.') {
+            i++;
+            while (w < 100000000000ull && p.len - i >= 8 && _str_parse_digits8(p.str + i, 10, &v) == 8) {
+                w = 100000000*w + v;
+                got_digit = 1;
+                q -= 8;
+                i += 8;
+            }
+            for (; i < p.len && (u8) (p.str[i] - '0') < 10; i++) {
+                u8 digit = (u8) (p.str[i] - '0');
+                got_digit = 1;
+                if (w < 1000000000000000000ull) {
+                    w = 10*w + digit;
+                    q--;
                 } else {
-                    break;
+                    truncated |= (digit != 0);
                 }
             }
-            if (zeros > 0) {
-                exp_offset += zeros;
+        }
+        if (!got_digit) {
+            return 0.0;
+        }
+        str mantissa = str_first(p, i);
+
+        s64 exp10 = 0;
+        if (i < p.len && (p.str[i]|32) == 'e') {
+            s64 exp = 0;
+            s32 exp_sign = 1, got_exp = 0;
+            i++;
+            if (i < p.len && (p.str[i] == '+' || p.str[i] == '-')) {
+                exp_sign = (p.str[i] == '-')? -1 : 1;
+                i++;
             }
-            p.str += i; p.len -= i;
-        } else {
-            s32 len = MIN((s32)p.len, 19); // NOTE(lf): 19 = floor(log10(2^64))
-            s32 zeros = 0;
-
-            { // Catch garbage strings
-                u8 digit = *p.str - '0';
-                if (digit >= 10) {
-                    if (failure) *failure = 1;
-                    return 0.0;
-                }
+            for (; i < p.len && (u8) (p.str[i] - '0') < 10; i++) {
+                got_exp = 1;
+                if (exp < 100000) exp = 10*exp + (p.str[i] - '0');
             }
-                
-            for (i = 0; i < len; i++) {
-                if (p.str[i] == '.') {
-                    if (got_frac) {
-                        p.len = i;
-                        break;
-                    }
-                    got_frac = 1;
-                    
-                    while (zeros > 0) {
-                        mantissa *= 10;
-                        zeros--;
-                    }
-
-                    exp_offset = 0; 
-                    continue;
-                }
-            
-                u8 digit = p.str[i] - '0';
-                if (digit < 10) {
-                    if (digit > 0) {
-                        if (got_frac) {
-                            exp_offset -= 1 + zeros;
-                        }
-                        while (zeros > 0) {
-                            mantissa *= 10;
-                            zeros--;
-                        }
-                        mantissa = mantissa*10 + digit; 
-                    } else {
-                        zeros++;
-                    }
-                } else {
-                    break;
-                }
+            if (!got_exp) {
+                return 0.0;
             }
-            if (zeros > 0) {
-                exp_offset += zeros;
+            exp10 = exp_sign*exp;
+            q += exp10;
+        }
+
+        if (w == 0) {
+            bits = 0;
+        } else if (!truncated && w <= (1ull << 53) && q >= -22 && q <= 22) {
+            /* Both w and 10^|q| are exact doubles, so one rounding */
+            f64 f = (f64) w;
+            f = (q < 0)? f / _str_pow10_exact[-q] : f * _str_pow10_exact[q];
+            if (failure) *failure = 0;
+            return sign? -f : f;
+        } else {
+            bits = _str_eisel_lemire(w, q);
+            if (truncated && bits != _str_eisel_lemire(w + 1, q)) {
+                bits = _str_decimal_to_bits(mantissa, exp10);
             }
-            p.str += i; p.len -= i;
         }
     }
 
-    if (mantissa == 0) {
-        if (failure) *failure = 0;
-        return sign == -1? -0.0 : 0.0;
+    if (failure) *failure = 0;
+    return _str_f64_from_bits(bits | sign);
+}
+
+/* Float formatting
+   Schubfach finds the shortest decimal in the rounding interval of a float, the interval of
+   values that read back as that float, picking the one closest to the exact value. Scaling by
+   a power of ten is one 64x128 bit multiply with a 128 bit approximation of 10^k, rounded up,
+   and the round-to-odd makes the approximation error not matter.
+   REF(lcf) Giulietti. The Schubfach way to render doubles.
+            https://drive.google.com/file/d/1gp5xv4CAa78SVgCeWfGqqI4FfYYYuNFb
+   REF(lcf) https://github.com/abolz/Drachennest, which this follows. */
+#define STR_SHORTEST_MIN_POW10 (-292)
+#define STR_SHORTEST_MAX_POW10 324
+
+/* 10^k normalized to 128 bits and rounded up, {high, low}, for k in [-292, 324]. Generated with:
+     for k in range(-292, 325):
+         v = Fraction(10)**k; r = 127 - (v.numerator.bit_length() - v.denominator.bit_length())
+         while v*2**r < 2**127: r += 1
+         while v*2**r >= 2**128: r -= 1
+         c = ceil(v*2**r) */
+static read_only u64 _str_pow10_128[STR_SHORTEST_MAX_POW10 - STR_SHORTEST_MIN_POW10 + 1][2] = {
+    {0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7b}, {0x9faacf3df73609b1, 0x77b191618c54e9ad},
+    {0xc795830d75038c1d, 0xd59df5b9ef6a2418}, {0xf97ae3d0d2446f25, 0x4b0573286b44ad1e},
+    {0x9becce62836ac577, 0x4ee367f9430aec33}, {0xc2e801fb244576d5, 0x229c41f793cda740},
+    {0xf3a20279ed56d48a, 0x6b43527578c11110}, {0x9845418c345644d6, 0x830a13896b78aaaa},
+    {0xbe5691ef416bd60c, 0x23cc986bc656d554}, {0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa9},
+    {0x94b3a202eb1c3f39, 0x7bf7d71432f3d6aa}, {0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc54},
+    {0xe858ad248f5c22c9, 0xd1b3400f8f9cff69}, {0x91376c36d99995be, 0x23100809b9c21fa2},
+    {0xb58547448ffffb2d, 0xabd40a0c2832a78b}, {0xe2e69915b3fff9f9, 0x16c90c8f323f516d},
+    {0x8dd01fad907ffc3b, 0xae3da7d97f6792e4}, {0xb1442798f49ffb4a, 0x99cd11cfdf41779d},
+    {0xdd95317f31c7fa1d, 0x40405643d711d584}, {0x8a7d3eef7f1cfc52, 0x482835ea666b2573},
+    {0xad1c8eab5ee43b66, 0xda3243650005eed0}, {0xd863b256369d4a40, 0x90bed43e40076a83},
+    {0x873e4f75e2224e68, 0x5a7744a6e804a292}, {0xa90de3535aaae202, 0x711515d0a205cb37},
+    {0xd3515c2831559a83, 0x0d5a5b44ca873e04}, {0x8412d9991ed58091, 0xe858790afe9486c3},
+    {0xa5178fff668ae0b6, 0x626e974dbe39a873}, {0xce5d73ff402d98e3, 0xfb0a3d212dc81290},
+    {0x80fa687f881c7f8e, 0x7ce66634bc9d0b9a}, {0xa139029f6a239f72, 0x1c1fffc1ebc44e81},
+    {0xc987434744ac874e, 0xa327ffb266b56221}, {0xfbe9141915d7a922, 0x4bf1ff9f0062baa9},
+    {0x9d71ac8fada6c9b5, 0x6f773fc3603db4aa}, {0xc4ce17b399107c22, 0xcb550fb4384d21d4},
+    {0xf6019da07f549b2b, 0x7e2a53a146606a49}, {0x99c102844f94e0fb, 0x2eda7444cbfc426e},
+    {0xc0314325637a1939, 0xfa911155fefb5309}, {0xf03d93eebc589f88, 0x793555ab7eba27cb},
+    {0x96267c7535b763b5, 0x4bc1558b2f3458df}, {0xbbb01b9283253ca2, 0x9eb1aaedfb016f17},
+    {0xea9c227723ee8bcb, 0x465e15a979c1cadd}, {0x92a1958a7675175f, 0x0bfacd89ec191eca},
+    {0xb749faed14125d36, 0xcef980ec671f667c}, {0xe51c79a85916f484, 0x82b7e12780e7401b},
+    {0x8f31cc0937ae58d2, 0xd1b2ecb8b0908811}, {0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa16},
+    {0xdfbdcece67006ac9, 0x67a791e093e1d49b}, {0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e1},
+    {0xaecc49914078536d, 0x58fae9f773886e19}, {0xda7f5bf590966848, 0xaf39a475506a899f},
+    {0x888f99797a5e012d, 0x6d8406c952429604}, {0xaab37fd7d8f58178, 0xc8e5087ba6d33b84},
+    {0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a65}, {0x855c3be0a17fcd26, 0x5cf2eea09a550680},
+    {0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481f}, {0xd0601d8efc57b08b, 0xf13b94daf124da27},
+    {0x823c12795db6ce57, 0x76c53d08d6b70859}, {0xa2cb1717b52481ed, 0x54768c4b0c64ca6f},
+    {0xcb7ddcdda26da268, 0xa9942f5dcf7dfd0a}, {0xfe5d54150b090b02, 0xd3f93b35435d7c4d},
+    {0x9efa548d26e5a6e1, 0xc47bc5014a1a6db0}, {0xc6b8e9b0709f109a, 0x359ab6419ca1091c},
+    {0xf867241c8cc6d4c0, 0xc30163d203c94b63}, {0x9b407691d7fc44f8, 0x79e0de63425dcf1e},
+    {0xc21094364dfb5636, 0x985915fc12f542e5}, {0xf294b943e17a2bc4, 0x3e6f5b7b17b2939e},
+    {0x979cf3ca6cec5b5a, 0xa705992ceecf9c43}, {0xbd8430bd08277231, 0x50c6ff782a838354},
+    {0xece53cec4a314ebd, 0xa4f8bf5635246429}, {0x940f4613ae5ed136, 0x871b7795e136be9a},
+    {0xb913179899f68584, 0x28e2557b59846e40}, {0xe757dd7ec07426e5, 0x331aeada2fe589d0},
+    {0x9096ea6f3848984f, 0x3ff0d2c85def7622}, {0xb4bca50b065abe63, 0x0fed077a756b53aa},
+    {0xe1ebce4dc7f16dfb, 0xd3e8495912c62895}, {0x8d3360f09cf6e4bd, 0x64712dd7abbbd95d},
+    {0xb080392cc4349dec, 0xbd8d794d96aacfb4}, {0xdca04777f541c567, 0xecf0d7a0fc5583a1},
+    {0x89e42caaf9491b60, 0xf41686c49db57245}, {0xac5d37d5b79b6239, 0x311c2875c522ced6},
+    {0xd77485cb25823ac7, 0x7d633293366b828c}, {0x86a8d39ef77164bc, 0xae5dff9c02033198},
+    {0xa8530886b54dbdeb, 0xd9f57f830283fdfd}, {0xd267caa862a12d66, 0xd072df63c324fd7c},
+    {0x8380dea93da4bc60, 0x4247cb9e59f71e6e}, {0xa46116538d0deb78, 0x52d9be85f074e609},
+    {0xcd795be870516656, 0x67902e276c921f8c}, {0x806bd9714632dff6, 0x00ba1cd8a3db53b7},
+    {0xa086cfcd97bf97f3, 0x80e8a40eccd228a5}, {0xc8a883c0fdaf7df0, 0x6122cd128006b2ce},
+    {0xfad2a4b13d1b5d6c, 0x796b805720085f82}, {0x9cc3a6eec6311a63, 0xcbe3303674053bb1},
+    {0xc3f490aa77bd60fc, 0xbedbfc4411068a9d}, {0xf4f1b4d515acb93b, 0xee92fb5515482d45},
+    {0x991711052d8bf3c5, 0x751bdd152d4d1c4b}, {0xbf5cd54678eef0b6, 0xd262d45a78a0635e},
+    {0xef340a98172aace4, 0x86fb897116c87c35}, {0x9580869f0e7aac0e, 0xd45d35e6ae3d4da1},
+    {0xbae0a846d2195712, 0x8974836059cca10a}, {0xe998d258869facd7, 0x2bd1a438703fc94c},
+    {0x91ff83775423cc06, 0x7b6306a34627ddd0}, {0xb67f6455292cbf08, 0x1a3bc84c17b1d543},
+    {0xe41f3d6a7377eeca, 0x20caba5f1d9e4a94}, {0x8e938662882af53e, 0x547eb47b7282ee9d},
+    {0xb23867fb2a35b28d, 0xe99e619a4f23aa44}, {0xdec681f9f4c31f31, 0x6405fa00e2ec94d5},
+    {0x8b3c113c38f9f37e, 0xde83bc408dd3dd05}, {0xae0b158b4738705e, 0x9624ab50b148d446},
+    {0xd98ddaee19068c76, 0x3badd624dd9b0958}, {0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d7},
+    {0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4d}, {0xd47487cc8470652b, 0x7647c32000696720},
+    {0x84c8d4dfd2c63f3b, 0x29ecd9f40041e074}, {0xa5fb0a17c777cf09, 0xf468107100525891},
+    {0xcf79cc9db955c2cc, 0x7182148d4066eeb5}, {0x81ac1fe293d599bf, 0xc6f14cd848405531},
+    {0xa21727db38cb002f, 0xb8ada00e5a506a7d}, {0xca9cf1d206fdc03b, 0xa6d90811f0e4851d},
+    {0xfd442e4688bd304a, 0x908f4a166d1da664}, {0x9e4a9cec15763e2e, 0x9a598e4e043287ff},
+    {0xc5dd44271ad3cdba, 0x40eff1e1853f29fe}, {0xf7549530e188c128, 0xd12bee59e68ef47d},
+    {0x9a94dd3e8cf578b9, 0x82bb74f8301958cf}, {0xc13a148e3032d6e7, 0xe36a52363c1faf02},
+    {0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac2}, {0x96f5600f15a7b7e5, 0x29ab103a5ef8c0ba},
+    {0xbcb2b812db11a5de, 0x7415d448f6b6f0e8}, {0xebdf661791d60f56, 0x111b495b3464ad22},
+    {0x936b9fcebb25c995, 0xcab10dd900beec35}, {0xb84687c269ef3bfb, 0x3d5d514f40eea743},
+    {0xe65829b3046b0afa, 0x0cb4a5a3112a5113}, {0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ac},
+    {0xb3f4e093db73a093, 0x59ed216765690f57}, {0xe0f218b8d25088b8, 0x306869c13ec3532d},
+    {0x8c974f7383725573, 0x1e414218c73a13fc}, {0xafbd2350644eeacf, 0xe5d1929ef90898fb},
+    {0xdbac6c247d62a583, 0xdf45f746b74abf3a}, {0x894bc396ce5da772, 0x6b8bba8c328eb784},
+    {0xab9eb47c81f5114f, 0x066ea92f3f326565}, {0xd686619ba27255a2, 0xc80a537b0efefebe},
+    {0x8613fd0145877585, 0xbd06742ce95f5f37}, {0xa798fc4196e952e7, 0x2c48113823b73705},
+    {0xd17f3b51fca3a7a0, 0xf75a15862ca504c6}, {0x82ef85133de648c4, 0x9a984d73dbe722fc},
+    {0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebbb}, {0xcc963fee10b7d1b3, 0x318df905079926a9},
+    {0xffbbcfe994e5c61f, 0xfdf17746497f7053}, {0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa634},
+    {0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc1}, {0xf9bd690a1b68637b, 0x3dfdce7aa3c673b1},
+    {0x9c1661a651213e2d, 0x06bea10ca65c084f}, {0xc31bfa0fe5698db8, 0x486e494fcff30a63},
+    {0xf3e2f893dec3f126, 0x5a89dba3c3efccfb}, {0x986ddb5c6b3a76b7, 0xf89629465a75e01d},
+    {0xbe89523386091465, 0xf6bbb397f1135824}, {0xee2ba6c0678b597f, 0x746aa07ded582e2d},
+    {0x94db483840b717ef, 0xa8c2a44eb4571cdd}, {0xba121a4650e4ddeb, 0x92f34d62616ce414},
+    {0xe896a0d7e51e1566, 0x77b020baf9c81d18}, {0x915e2486ef32cd60, 0x0ace1474dc1d122f},
+    {0xb5b5ada8aaff80b8, 0x0d819992132456bb}, {0xe3231912d5bf60e6, 0x10e1fff697ed6c6a},
+    {0x8df5efabc5979c8f, 0xca8d3ffa1ef463c2}, {0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb3},
+    {0xddd0467c64bce4a0, 0xac7cb3f6d05ddbdf}, {0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96c},
+    {0xad4ab7112eb3929d, 0x86c16c98d2c953c7}, {0xd89d64d57a607744, 0xe871c7bf077ba8b8},
+    {0x87625f056c7c4a8b, 0x11471cd764ad4973}, {0xa93af6c6c79b5d2d, 0xd598e40d3dd89bd0},
+    {0xd389b47879823479, 0x4aff1d108d4ec2c4}, {0x843610cb4bf160cb, 0xcedf722a585139bb},
+    {0xa54394fe1eedb8fe, 0xc2974eb4ee658829}, {0xce947a3da6a9273e, 0x733d226229feea33},
+    {0x811ccc668829b887, 0x0806357d5a3f5260}, {0xa163ff802a3426a8, 0xca07c2dcb0cf26f8},
+    {0xc9bcff6034c13052, 0xfc89b393dd02f0b6}, {0xfc2c3f3841f17c67, 0xbbac2078d443ace3},
+    {0x9d9ba7832936edc0, 0xd54b944b84aa4c0e}, {0xc5029163f384a931, 0x0a9e795e65d4df12},
+    {0xf64335bcf065d37d, 0x4d4617b5ff4a16d6}, {0x99ea0196163fa42e, 0x504bced1bf8e4e46},
+    {0xc06481fb9bcf8d39, 0xe45ec2862f71e1d7}, {0xf07da27a82c37088, 0x5d767327bb4e5a4d},
+    {0x964e858c91ba2655, 0x3a6a07f8d510f870}, {0xbbe226efb628afea, 0x890489f70a55368c},
+    {0xeadab0aba3b2dbe5, 0x2b45ac74ccea842f}, {0x92c8ae6b464fc96f, 0x3b0b8bc90012929e},
+    {0xb77ada0617e3bbcb, 0x09ce6ebb40173745}, {0xe55990879ddcaabd, 0xcc420a6a101d0516},
+    {0x8f57fa54c2a9eab6, 0x9fa946824a12232e}, {0xb32df8e9f3546564, 0x47939822dc96abfa},
+    {0xdff9772470297ebd, 0x59787e2b93bc56f8}, {0x8bfbea76c619ef36, 0x57eb4edb3c55b65b},
+    {0xaefae51477a06b03, 0xede622920b6b23f2}, {0xdab99e59958885c4, 0xe95fab368e45ecee},
+    {0x88b402f7fd75539b, 0x11dbcb0218ebb415}, {0xaae103b5fcd2a881, 0xd652bdc29f26a11a},
+    {0xd59944a37c0752a2, 0x4be76d3346f04960}, {0x857fcae62d8493a5, 0x6f70a4400c562ddc},
+    {0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb953}, {0xd097ad07a71f26b2, 0x7e2000a41346a7a8},
+    {0x825ecc24c873782f, 0x8ed400668c0c28c9}, {0xa2f67f2dfa90563b, 0x728900802f0f32fb},
+    {0xcbb41ef979346bca, 0x4f2b40a03ad2ffba}, {0xfea126b7d78186bc, 0xe2f610c84987bfa9},
+    {0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7ca}, {0xc6ede63fa05d3143, 0x91503d1c79720dbc},
+    {0xf8a95fcf88747d94, 0x75a44c6397ce912b}, {0x9b69dbe1b548ce7c, 0xc986afbe3ee11abb},
+    {0xc24452da229b021b, 0xfbe85badce996169}, {0xf2d56790ab41c2a2, 0xfae27299423fb9c4},
+    {0x97c560ba6b0919a5, 0xdccd879fc967d41b}, {0xbdb6b8e905cb600f, 0x5400e987bbc1c921},
+    {0xed246723473e3813, 0x290123e9aab23b69}, {0x9436c0760c86e30b, 0xf9a0b6720aaf6522},
+    {0xb94470938fa89bce, 0xf808e40e8d5b3e6a}, {0xe7958cb87392c2c2, 0xb60b1d1230b20e05},
+    {0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c3}, {0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af4},
+    {0xe2280b6c20dd5232, 0x25c6da63c38de1b1}, {0x8d590723948a535f, 0x579c487e5a38ad0f},
+    {0xb0af48ec79ace837, 0x2d835a9df0c6d852}, {0xdcdb1b2798182244, 0xf8e431456cf88e66},
+    {0x8a08f0f8bf0f156b, 0x1b8e9ecb641b5900}, {0xac8b2d36eed2dac5, 0xe272467e3d222f40},
+    {0xd7adf884aa879177, 0x5b0ed81dcc6abb10}, {0x86ccbb52ea94baea, 0x98e947129fc2b4ea},
+    {0xa87fea27a539e9a5, 0x3f2398d747b36225}, {0xd29fe4b18e88640e, 0x8eec7f0d19a03aae},
+    {0x83a3eeeef9153e89, 0x1953cf68300424ad}, {0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd8},
+    {0xcdb02555653131b6, 0x3792f412cb06794e}, {0x808e17555f3ebf11, 0xe2bbd88bbee40bd1},
+    {0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec5}, {0xc8de047564d20a8b, 0xf245825a5a445276},
+    {0xfb158592be068d2e, 0xeed6e2f0f0d56713}, {0x9ced737bb6c4183d, 0x55464dd69685606c},
+    {0xc428d05aa4751e4c, 0xaa97e14c3c26b887}, {0xf53304714d9265df, 0xd53dd99f4b3066a9},
+    {0x993fe2c6d07b7fab, 0xe546a8038efe402a}, {0xbf8fdb78849a5f96, 0xde98520472bdd034},
+    {0xef73d256a5c0f77c, 0x963e66858f6d4441}, {0x95a8637627989aad, 0xdde7001379a44aa9},
+    {0xbb127c53b17ec159, 0x5560c018580d5d53}, {0xe9d71b689dde71af, 0xaab8f01e6e10b4a7},
+    {0x9226712162ab070d, 0xcab3961304ca70e9}, {0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d23},
+    {0xe45c10c42a2b3b05, 0x8cb89a7db77c506b}, {0x8eb98a7a9a5b04e3, 0x77f3608e92adb243},
+    {0xb267ed1940f1c61c, 0x55f038b237591ed4}, {0xdf01e85f912e37a3, 0x6b6c46dec52f6689},
+    {0x8b61313bbabce2c6, 0x2323ac4b3b3da016}, {0xae397d8aa96c1b77, 0xabec975e0a0d081b},
+    {0xd9c7dced53c72255, 0x96e7bd358c904a22}, {0x881cea14545c7575, 0x7e50d64177da2e55},
+    {0xaa242499697392d2, 0xdde50bd1d5d0b9ea}, {0xd4ad2dbfc3d07787, 0x955e4ec64b44e865},
+    {0x84ec3c97da624ab4, 0xbd5af13bef0b113f}, {0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58f},
+    {0xcfb11ead453994ba, 0x67de18eda5814af3}, {0x81ceb32c4b43fcf4, 0x80eacf948770ced8},
+    {0xa2425ff75e14fc31, 0xa1258379a94d028e}, {0xcad2f7f5359a3b3e, 0x096ee45813a04331},
+    {0xfd87b5f28300ca0d, 0x8bca9d6e188853fd}, {0x9e74d1b791e07e48, 0x775ea264cf55347e},
+    {0xc612062576589dda, 0x95364afe032a819e}, {0xf79687aed3eec551, 0x3a83ddbd83f52205},
+    {0x9abe14cd44753b52, 0xc4926a9672793543}, {0xc16d9a0095928a27, 0x75b7053c0f178294},
+    {0xf1c90080baf72cb1, 0x5324c68b12dd6339}, {0x971da05074da7bee, 0xd3f6fc16ebca5e04},
+    {0xbce5086492111aea, 0x88f4bb1ca6bcf585}, {0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6},
+    {0x9392ee8e921d5d07, 0x3aff322e62439fd0}, {0xb877aa3236a4b449, 0x09befeb9fad487c3},
+    {0xe69594bec44de15b, 0x4c2ebe687989a9b4}, {0x901d7cf73ab0acd9, 0x0f9d37014bf60a11},
+    {0xb424dc35095cd80f, 0x538484c19ef38c95}, {0xe12e13424bb40e13, 0x2865a5f206b06fba},
+    {0x8cbccc096f5088cb, 0xf93f87b7442e45d4}, {0xafebff0bcb24aafe, 0xf78f69a51539d749},
+    {0xdbe6fecebdedd5be, 0xb573440e5a884d1c}, {0x89705f4136b4a597, 0x31680a88f8953031},
+    {0xabcc77118461cefc, 0xfdc20d2b36ba7c3e}, {0xd6bf94d5e57a42bc, 0x3d32907604691b4d},
+    {0x8637bd05af6c69b5, 0xa63f9a49c2c1b110}, {0xa7c5ac471b478423, 0x0fcf80dc33721d54},
+    {0xd1b71758e219652b, 0xd3c36113404ea4a9}, {0x83126e978d4fdf3b, 0x645a1cac083126ea},
+    {0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4}, {0xcccccccccccccccc, 0xcccccccccccccccd},
+    {0x8000000000000000, 0x0000000000000000}, {0xa000000000000000, 0x0000000000000000},
+    {0xc800000000000000, 0x0000000000000000}, {0xfa00000000000000, 0x0000000000000000},
+    {0x9c40000000000000, 0x0000000000000000}, {0xc350000000000000, 0x0000000000000000},
+    {0xf424000000000000, 0x0000000000000000}, {0x9896800000000000, 0x0000000000000000},
+    {0xbebc200000000000, 0x0000000000000000}, {0xee6b280000000000, 0x0000000000000000},
+    {0x9502f90000000000, 0x0000000000000000}, {0xba43b74000000000, 0x0000000000000000},
+    {0xe8d4a51000000000, 0x0000000000000000}, {0x9184e72a00000000, 0x0000000000000000},
+    {0xb5e620f480000000, 0x0000000000000000}, {0xe35fa931a0000000, 0x0000000000000000},
+    {0x8e1bc9bf04000000, 0x0000000000000000}, {0xb1a2bc2ec5000000, 0x0000000000000000},
+    {0xde0b6b3a76400000, 0x0000000000000000}, {0x8ac7230489e80000, 0x0000000000000000},
+    {0xad78ebc5ac620000, 0x0000000000000000}, {0xd8d726b7177a8000, 0x0000000000000000},
+    {0x878678326eac9000, 0x0000000000000000}, {0xa968163f0a57b400, 0x0000000000000000},
+    {0xd3c21bcecceda100, 0x0000000000000000}, {0x84595161401484a0, 0x0000000000000000},
+    {0xa56fa5b99019a5c8, 0x0000000000000000}, {0xcecb8f27f4200f3a, 0x0000000000000000},
+    {0x813f3978f8940984, 0x4000000000000000}, {0xa18f07d736b90be5, 0x5000000000000000},
+    {0xc9f2c9cd04674ede, 0xa400000000000000}, {0xfc6f7c4045812296, 0x4d00000000000000},
+    {0x9dc5ada82b70b59d, 0xf020000000000000}, {0xc5371912364ce305, 0x6c28000000000000},
+    {0xf684df56c3e01bc6, 0xc732000000000000}, {0x9a130b963a6c115c, 0x3c7f400000000000},
+    {0xc097ce7bc90715b3, 0x4b9f100000000000}, {0xf0bdc21abb48db20, 0x1e86d40000000000},
+    {0x96769950b50d88f4, 0x1314448000000000}, {0xbc143fa4e250eb31, 0x17d955a000000000},
+    {0xeb194f8e1ae525fd, 0x5dcfab0800000000}, {0x92efd1b8d0cf37be, 0x5aa1cae500000000},
+    {0xb7abc627050305ad, 0xf14a3d9e40000000}, {0xe596b7b0c643c719, 0x6d9ccd05d0000000},
+    {0x8f7e32ce7bea5c6f, 0xe4820023a2000000}, {0xb35dbf821ae4f38b, 0xdda2802c8a800000},
+    {0xe0352f62a19e306e, 0xd50b2037ad200000}, {0x8c213d9da502de45, 0x4526f422cc340000},
+    {0xaf298d050e4395d6, 0x9670b12b7f410000}, {0xdaf3f04651d47b4c, 0x3c0cdd765f114000},
+    {0x88d8762bf324cd0f, 0xa5880a69fb6ac800}, {0xab0e93b6efee0053, 0x8eea0d047a457a00},
+    {0xd5d238a4abe98068, 0x72a4904598d6d880}, {0x85a36366eb71f041, 0x47a6da2b7f864750},
+    {0xa70c3c40a64e6c51, 0x999090b65f67d924}, {0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d},
+    {0x82818f1281ed449f, 0xbff8f10e7a8921a5}, {0xa321f2d7226895c7, 0xaff72d52192b6a0e},
+    {0xcbea6f8ceb02bb39, 0x9bf4f8a69f764491}, {0xfee50b7025c36a08, 0x02f236d04753d5b5},
+    {0x9f4f2726179a2245, 0x01d762422c946591}, {0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef6},
+    {0xf8ebad2b84e0d58b, 0xd2e0898765a7deb3}, {0x9b934c3b330c8577, 0x63cc55f49f88eb30},
+    {0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fc}, {0xf316271c7fc3908a, 0x8bef464e3945ef7b},
+    {0x97edd871cfda3a56, 0x97758bf0e3cbb5ad}, {0xbde94e8e43d0c8ec, 0x3d52eeed1cbea318},
+    {0xed63a231d4c4fb27, 0x4ca7aaa863ee4bde}, {0x945e455f24fb1cf8, 0x8fe8caa93e74ef6b},
+    {0xb975d6b6ee39e436, 0xb3e2fd538e122b45}, {0xe7d34c64a9c85d44, 0x60dbbca87196b617},
+    {0x90e40fbeea1d3a4a, 0xbc8955e946fe31ce}, {0xb51d13aea4a488dd, 0x6babab6398bdbe42},
+    {0xe264589a4dcdab14, 0xc696963c7eed2dd2}, {0x8d7eb76070a08aec, 0xfc1e1de5cf543ca3},
+    {0xb0de65388cc8ada8, 0x3b25a55f43294bcc}, {0xdd15fe86affad912, 0x49ef0eb713f39ebf},
+    {0x8a2dbf142dfcc7ab, 0x6e3569326c784338}, {0xacb92ed9397bf996, 0x49c2c37f07965405},
+    {0xd7e77a8f87daf7fb, 0xdc33745ec97be907}, {0x86f0ac99b4e8dafd, 0x69a028bb3ded71a4},
+    {0xa8acd7c0222311bc, 0xc40832ea0d68ce0d}, {0xd2d80db02aabd62b, 0xf50a3fa490c30191},
+    {0x83c7088e1aab65db, 0x792667c6da79e0fb}, {0xa4b8cab1a1563f52, 0x577001b891185939},
+    {0xcde6fd5e09abcf26, 0xed4c0226b55e6f87}, {0x80b05e5ac60b6178, 0x544f8158315b05b5},
+    {0xa0dc75f1778e39d6, 0x696361ae3db1c722}, {0xc913936dd571c84c, 0x03bc3a19cd1e38ea},
+    {0xfb5878494ace3a5f, 0x04ab48a04065c724}, {0x9d174b2dcec0e47b, 0x62eb0d64283f9c77},
+    {0xc45d1df942711d9a, 0x3ba5d0bd324f8395}, {0xf5746577930d6500, 0xca8f44ec7ee3647a},
+    {0x9968bf6abbe85f20, 0x7e998b13cf4e1ecc}, {0xbfc2ef456ae276e8, 0x9e3fedd8c321a67f},
+    {0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101f}, {0x95d04aee3b80ece5, 0xbba1f1d158724a13},
+    {0xbb445da9ca61281f, 0x2a8a6e45ae8edc98}, {0xea1575143cf97226, 0xf52d09d71a3293be},
+    {0x924d692ca61be758, 0x593c2626705f9c57}, {0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836d},
+    {0xe498f455c38b997a, 0x0b6dfb9c0f956448}, {0x8edf98b59a373fec, 0x4724bd4189bd5ead},
+    {0xb2977ee300c50fe7, 0x58edec91ec2cb658}, {0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ee},
+    {0x8b865b215899f46c, 0xbd79e0d20082ee75}, {0xae67f1e9aec07187, 0xecd8590680a3aa12},
+    {0xda01ee641a708de9, 0xe80e6f4820cc9496}, {0x884134fe908658b2, 0x3109058d147fdcde},
+    {0xaa51823e34a7eede, 0xbd4b46f0599fd416}, {0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91b},
+    {0x850fadc09923329e, 0x03e2cf6bc604ddb1}, {0xa6539930bf6bff45, 0x84db8346b786151d},
+    {0xcfe87f7cef46ff16, 0xe612641865679a64}, {0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07f},
+    {0xa26da3999aef7749, 0xe3be5e330f38f09e}, {0xcb090c8001ab551c, 0x5cadf5bfd3072cc6},
+    {0xfdcb4fa002162a63, 0x73d9732fc7c8f7f7}, {0x9e9f11c4014dda7e, 0x2867e7fddcdd9afb},
+    {0xc646d63501a1511d, 0xb281e1fd541501b9}, {0xf7d88bc24209a565, 0x1f225a7ca91a4227},
+    {0x9ae757596946075f, 0x3375788de9b06959}, {0xc1a12d2fc3978937, 0x0052d6b1641c83af},
+    {0xf209787bb47d6b84, 0xc0678c5dbd23a49b}, {0x9745eb4d50ce6332, 0xf840b7ba963646e1},
+    {0xbd176620a501fbff, 0xb650e5a93bc3d899}, {0xec5d3fa8ce427aff, 0xa3e51f138ab4cebf},
+    {0x93ba47c980e98cdf, 0xc66f336c36b10138}, {0xb8a8d9bbe123f017, 0xb80b0047445d4185},
+    {0xe6d3102ad96cec1d, 0xa60dc059157491e6}, {0x9043ea1ac7e41392, 0x87c89837ad68db30},
+    {0xb454e4a179dd1877, 0x29babe4598c311fc}, {0xe16a1dc9d8545e94, 0xf4296dd6fef3d67b},
+    {0x8ce2529e2734bb1d, 0x1899e4a65f58660d}, {0xb01ae745b101e9e4, 0x5ec05dcff72e7f90},
+    {0xdc21a1171d42645d, 0x76707543f4fa1f74}, {0x899504ae72497eba, 0x6a06494a791c53a9},
+    {0xabfa45da0edbde69, 0x0487db9d17636893}, {0xd6f8d7509292d603, 0x45a9d2845d3c42b7},
+    {0x865b86925b9bc5c2, 0x0b8a2392ba45a9b3}, {0xa7f26836f282b732, 0x8e6cac7768d7141f},
+    {0xd1ef0244af2364ff, 0x3207d795430cd927}, {0x8335616aed761f1f, 0x7f44e6bd49e807b9},
+    {0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a7}, {0xcd036837130890a1, 0x36dba887c37a8c10},
+    {0x802221226be55a64, 0xc2494954da2c978a}, {0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6d},
+    {0xc83553c5c8965d3d, 0x6f92829494e5acc8}, {0xfa42a8b73abbf48c, 0xcb772339ba1f17fa},
+    {0x9c69a97284b578d7, 0xff2a760414536efc}, {0xc38413cf25e2d70d, 0xfef5138519684abb},
+    {0xf46518c2ef5b8cd1, 0x7eb258665fc25d6a}, {0x98bf2f79d5993802, 0xef2f773ffbd97a62},
+    {0xbeeefb584aff8603, 0xaafb550ffacfd8fb}, {0xeeaaba2e5dbf6784, 0x95ba2a53f983cf39},
+    {0x952ab45cfa97a0b2, 0xdd945a747bf26184}, {0xba756174393d88df, 0x94f971119aeef9e5},
+    {0xe912b9d1478ceb17, 0x7a37cd5601aab85e}, {0x91abb422ccb812ee, 0xac62e055c10ab33b},
+    {0xb616a12b7fe617aa, 0x577b986b314d600a}, {0xe39c49765fdf9d94, 0xed5a7e85fda0b80c},
+    {0x8e41ade9fbebc27d, 0x14588f13be847308}, {0xb1d219647ae6b31c, 0x596eb2d8ae258fc9},
+    {0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bc}, {0x8aec23d680043bee, 0x25de7bb9480d5855},
+    {0xada72ccc20054ae9, 0xaf561aa79a10ae6b}, {0xd910f7ff28069da4, 0x1b2ba1518094da05},
+    {0x87aa9aff79042286, 0x90fb44d2f05d0843}, {0xa99541bf57452b28, 0x353a1607ac744a54},
+    {0xd3fa922f2d1675f2, 0x42889b8997915ce9}, {0x847c9b5d7c2e09b7, 0x69956135febada12},
+    {0xa59bc234db398c25, 0x43fab9837e699096}, {0xcf02b2c21207ef2e, 0x94f967e45e03f4bc},
+    {0x8161afb94b44f57d, 0x1d1be0eebac278f6}, {0xa1ba1ba79e1632dc, 0x6462d92a69731733},
+    {0xca28a291859bbf93, 0x7d7b8f7503cfdcff}, {0xfcb2cb35e702af78, 0x5cda735244c3d43f},
+    {0x9defbf01b061adab, 0x3a0888136afa64a8}, {0xc56baec21c7a1916, 0x088aaa1845b8fdd1},
+    {0xf6c69a72a3989f5b, 0x8aad549e57273d46}, {0x9a3c2087a63f6399, 0x36ac54e2f678864c},
+    {0xc0cb28a98fcf3c7f, 0x84576a1bb416a7de}, {0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d6},
+    {0x969eb7c47859e743, 0x9f644ae5a4b1b326}, {0xbc4665b596706114, 0x873d5d9f0dde1fef},
+    {0xeb57ff22fc0c7959, 0xa90cb506d155a7eb}, {0x9316ff75dd87cbd8, 0x09a7f12442d588f3},
+    {0xb7dcbf5354e9bece, 0x0c11ed6d538aeb30}, {0xe5d3ef282a242e81, 0x8f1668c8a86da5fb},
+    {0x8fa475791a569d10, 0xf96e017d694487bd}, {0xb38d92d760ec4455, 0x37c981dcc395a9ad},
+    {0xe070f78d3927556a, 0x85bbe253f47b1418}, {0x8c469ab843b89562, 0x93956d7478ccec8f},
+    {0xaf58416654a6babb, 0x387ac8d1970027b3}, {0xdb2e51bfe9d0696a, 0x06997b05fcc0319f},
+    {0x88fcf317f22241e2, 0x441fece3bdf81f04}, {0xab3c2fddeeaad25a, 0xd527e81cad7626c4},
+    {0xd60b3bd56a5586f1, 0x8a71e223d8d3b075}, {0x85c7056562757456, 0xf6872d5667844e4a},
+    {0xa738c6bebb12d16c, 0xb428f8ac016561dc}, {0xd106f86e69d785c7, 0xe13336d701beba53},
+    {0x82a45b450226b39c, 0xecc0024661173474}, {0xa34d721642b06084, 0x27f002d7f95d0191},
+    {0xcc20ce9bd35c78a5, 0x31ec038df7b441f5}, {0xff290242c83396ce, 0x7e67047175a15272},
+    {0x9f79a169bd203e41, 0x0f0062c6e984d387}, {0xc75809c42c684dd1, 0x52c07b78a3e60869},
+    {0xf92e0c3537826145, 0xa7709a56ccdf8a83}, {0x9bbcc7a142b17ccb, 0x88a66076400bb692},
+    {0xc2abf989935ddbfe, 0x6acff893d00ea436}, {0xf356f7ebf83552fe, 0x0583f6b8c4124d44},
+    {0x98165af37b2153de, 0xc3727a337a8b704b}, {0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5d},
+    {0xeda2ee1c7064130c, 0x1162def06f79df74}, {0x9485d4d1c63e8be7, 0x8addcb5645ac2ba9},
+    {0xb9a74a0637ce2ee1, 0x6d953e2bd7173693}, {0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0438},
+    {0x910ab1d4db9914a0, 0x1d9c9892400a22a3}, {0xb54d5e4a127f59c8, 0x2503beb6d00cab4c},
+    {0xe2a0b5dc971f303a, 0x2e44ae64840fd61e}, {0x8da471a9de737e24, 0x5ceaecfed289e5d3},
+    {0xb10d8e1456105dad, 0x7425a83e872c5f48}, {0xdd50f1996b947518, 0xd12f124e28f7771a},
+    {0x8a5296ffe33cc92f, 0x82bd6b70d99aaa70}, {0xace73cbfdc0bfb7b, 0x636cc64d1001550c},
+    {0xd8210befd30efa5a, 0x3c47f7e05401aa4f}, {0x8714a775e3e95c78, 0x65acfaec34810a72},
+    {0xa8d9d1535ce3b396, 0x7f1839a741a14d0e}, {0xd31045a8341ca07c, 0x1ede48111209a051},
+    {0x83ea2b892091e44d, 0x934aed0aab460433}, {0xa4e4b66b68b65d60, 0xf81da84d56178540},
+    {0xce1de40642e3f4b9, 0x36251260ab9d668f}, {0x80d2ae83e9ce78f3, 0xc1d72b7c6b42601a},
+    {0xa1075a24e4421730, 0xb24cf65b8612f820}, {0xc94930ae1d529cfc, 0xdee033f26797b628},
+    {0xfb9b7cd9a4a7443c, 0x169840ef017da3b2}, {0x9d412e0806e88aa5, 0x8e1f289560ee864f},
+    {0xc491798a08a2ad4e, 0xf1a6f2bab92a27e3}, {0xf5b5d7ec8acb58a2, 0xae10af696774b1dc},
+    {0x9991a6f3d6bf1765, 0xacca6da1e0a8ef2a}, {0xbff610b0cc6edd3f, 0x17fd090a58d32af4},
+    {0xeff394dcff8a948e, 0xddfc4b4cef07f5b1}, {0x95f83d0a1fb69cd9, 0x4abdaf101564f98f},
+    {0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f2}, {0xea53df5fd18d5513, 0x84c86189216dc5ee},
+    {0x92746b9be2f8552c, 0x32fd3cf5b4e49bb5}, {0xb7118682dbb66a77, 0x3fbc8c33221dc2a2},
+    {0xe4d5e82392a40515, 0x0fabaf3feaa5334b}, {0x8f05b1163ba6832d, 0x29cb4d87f2a7400f},
+    {0xb2c71d5bca9023f8, 0x743e20e9ef511013}, {0xdf78e4b2bd342cf6, 0x914da9246b255417},
+    {0x8bab8eefb6409c1a, 0x1ad089b6c2f7548f}, {0xae9672aba3d0c320, 0xa184ac2473b529b2},
+    {0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741f}, {0x8865899617fb1871, 0x7e2fa67c7a658893},
+    {0xaa7eebfb9df9de8d, 0xddbb901b98feeab8}, {0xd51ea6fa85785631, 0x552a74227f3ea566},
+    {0x8533285c936b35de, 0xd53a88958f872760}, {0xa67ff273b8460356, 0x8a892abaf368f138},
+    {0xd01fef10a657842c, 0x2d2b7569b0432d86}, {0x8213f56a67f6b29b, 0x9c3b29620e29fc74},
+    {0xa298f2c501f45f42, 0x8349f3ba91b47b90}, {0xcb3f2f7642717713, 0x241c70a936219a74},
+    {0xfe0efb53d30dd4d7, 0xed238cd383aa0111}, {0x9ec95d1463e8a506, 0xf4363804324a40ab},
+    {0xc67bb4597ce2ce48, 0xb143c6053edcd0d6}, {0xf81aa16fdc1b81da, 0xdd94b7868e94050b},
+    {0x9b10a4e5e9913128, 0xca7cf2b4191c8327}, {0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f1},
+    {0xf24a01a73cf2dccf, 0xbc633b39673c8ced}, {0x976e41088617ca01, 0xd5be0503e085d814},
+    {0xbd49d14aa79dbc82, 0x4b2d8644d8a74e19}, {0xec9c459d51852ba2, 0xddf8e7d60ed1219f},
+    {0x93e1ab8252f33b45, 0xcabb90e5c942b504}, {0xb8da1662e7b00a17, 0x3d6a751f3b936244},
+    {0xe7109bfba19c0c9d, 0x0cc512670a783ad5}, {0x906a617d450187e2, 0x27fb2b80668b24c6},
+    {0xb484f9dc9641e9da, 0xb1f9f660802dedf7}, {0xe1a63853bbd26451, 0x5e7873f8a0396974},
+    {0x8d07e33455637eb2, 0xdb0b487b6423e1e9}, {0xb049dc016abc5e5f, 0x91ce1a9a3d2cda63},
+    {0xdc5c5301c56b75f7, 0x7641a140cc7810fc}, {0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9e},
+    {0xac2820d9623bf429, 0x546345fa9fbdcd45}, {0xd732290fbacaf133, 0xa97c177947ad4096},
+    {0x867f59a9d4bed6c0, 0x49ed8eabcccc485e}, {0xa81f301449ee8c70, 0x5c68f256bfff5a75},
+    {0xd226fc195c6a2f8c, 0x73832eec6fff3112}, {0x83585d8fd9c25db7, 0xc831fd53c5ff7eac},
+    {0xa42e74f3d032f525, 0xba3e7ca8b77f5e56}, {0xcd3a1230c43fb26f, 0x28ce1bd2e55f35ec},
+    {0x80444b5e7aa7cf85, 0x7980d163cf5b81b4}, {0xa0555e361951c366, 0xd7e105bcc3326220},
+    {0xc86ab5c39fa63440, 0x8dd9472bf3fefaa8}, {0xfa856334878fc150, 0xb14f98f6f0feb952},
+    {0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d4}, {0xc3b8358109e84f07, 0x0a862f80ec4700c9},
+    {0xf4a642e14c6262c8, 0xcd27bb612758c0fb}, {0x98e7e9cccfbd7dbd, 0x8038d51cb897789d},
+    {0xbf21e44003acdd2c, 0xe0470a63e6bd56c4}, {0xeeea5d5004981478, 0x1858ccfce06cac75},
+    {0x95527a5202df0ccb, 0x0f37801e0c43ebc9}, {0xbaa718e68396cffd, 0xd30560258f54e6bb},
+    {0xe950df20247c83fd, 0x47c6b82ef32a206a}, {0x91d28b7416cdd27e, 0x4cdc331d57fa5442},
+    {0xb6472e511c81471d, 0xe0133fe4adf8e953}, {0xe3d8f9e563a198e5, 0x58180fddd97723a7},
+    {0x8e679c2f5e44ff8f, 0x570f09eaa7ea7649}, {0xb201833b35d63f73, 0x2cd2cc6551e513db},
+    {0xde81e40a034bcf4f, 0xf8077f7ea65e58d2}, {0x8b112e86420f6191, 0xfb04afaf27faf783},
+    {0xadd57a27d29339f6, 0x79c5db9af1f9b564}, {0xd94ad8b1c7380874, 0x18375281ae7822bd},
+    {0x87cec76f1c830548, 0x8f2293910d0b15b6}, {0xa9c2794ae3a3c69a, 0xb2eb3875504ddb23},
+    {0xd433179d9c8cb841, 0x5fa60692a46151ec}, {0x849feec281d7f328, 0xdbc7c41ba6bcd334},
+    {0xa5c7ea73224deff3, 0x12b9b522906c0801}, {0xcf39e50feae16bef, 0xd768226b34870a01},
+    {0x81842f29f2cce375, 0xe6a1158300d46641}, {0xa1e53af46f801c53, 0x60495ae3c1097fd1},
+    {0xca5e89b18b602368, 0x385bb19cb14bdfc5}, {0xfcf62c1dee382c42, 0x46729e03dd9ed7b6},
+    {0x9e19db92b4e31ba9, 0x6c07a2c26a8346d2},
+};
+
+/* floor(log10(2^e)), floor(log10(3/4 2^e)) and floor(log2(10^e)) for the exponents used */
+#define _str_floor_log10_pow2(e) (((e)*1262611) >> 22)
+#define _str_floor_log10_pow2_three_quarters(e) (((e)*1262611 - 524031) >> 22)
+#define _str_floor_log2_pow10(e) (((e)*1741647) >> 19)
+
+/* g*cp >> 128 with the bits shifted out ORed into the lowest bit */
+internal u64 _str_round_to_odd_f64(const u64 *g, u64 cp) {
+    u64 x_hi, y_hi;
+    mul_u64_wide(g[1], cp, &x_hi);
+    u64 y_lo = mul_u64_wide(g[0], cp, &y_hi);
+    u64 z = y_lo + x_hi;
+    y_hi += (z < y_lo);
+    return y_hi | (z > 1);
+}
+
+internal u32 _str_round_to_odd_f32(u64 g, u32 cp) {
+    u64 hi;
+    u64 lo = mul_u64_wide(g, cp, &hi);
+    return (u32) hi | ((u32) (lo >> 32) > 1);
+}
+
+/* Digits and power of ten of a finite, nonzero f64. The digits can have trailing zeros. */
+internal u64 _str_shortest_f64(u64 bits, s32 *exp10) {
+    u64 fraction = bits & ((1ull << 52) - 1);
+    s32 biased = (s32) ((bits >> 52) & 0x7FF);
+    u64 c;
+    s32 q;
+    if (biased != 0) {
+        c = fraction | (1ull << 52);
+        q = biased - 1075;
+        if (q <= 0 && q > -53 && (c & ((1ull << -q) - 1)) == 0) { /* Small integer */
+            *exp10 = 0;
+            return c >> -q;
+        }
+    } else {
+        c = fraction;
+        q = -1074;
     }
 
-    f64 f = sign*(f64)(mantissa);
-
-    s32 exp = 0;
-    char exp_delim = (is_hex)? 'p' : 'e';
-    for (i = 0; i < p.len; i++) {
-        if ((p.str[i]|32) == exp_delim) {
-            break;
+    s32 even = (c & 1) == 0;
+    s32 closer_below = (fraction == 0 && biased > 1);
+    u64 cbl = 4*c - 2 + closer_below;
+    u64 cb = 4*c;
+    u64 cbr = 4*c + 2;
+
+    s32 k = closer_below? _str_floor_log10_pow2_three_quarters(q) : _str_floor_log10_pow2(q);
+    s32 h = q + _str_floor_log2_pow10(-k) + 1;
+    const u64 *g = _str_pow10_128[-k - STR_SHORTEST_MIN_POW10];
+    u64 vbl = _str_round_to_odd_f64(g, cbl << h);
+    u64 vb = _str_round_to_odd_f64(g, cb << h);
+    u64 vbr = _str_round_to_odd_f64(g, cbr << h);
+    u64 lower = vbl + !even;
+    u64 upper = vbr - !even;
+
+    /* One digit less, if exactly one of its two neighbours is inside */
+    u64 s = vb / 4;
+    if (s >= 10) {
+        u64 sp = s / 10;
+        s32 up_inside = lower <= 40*sp;
+        s32 wp_inside = 40*sp + 40 <= upper;
+        if (up_inside != wp_inside) {
+            *exp10 = k + 1;
+            return sp + wp_inside;
         }
     }
-    p.str += i+1; p.len -= i+1;
-    
-    if (p.len > 0) {
-        s32 exp_sign = 1;
-        if (*p.str == '+' || *p.str == '-') {
-            exp_sign = (*p.str == '-')? -1 : 1;
-            p.str += 1; p.len -= 1;
+    s32 u_inside = lower <= 4*s;
+    s32 w_inside = 4*s + 4 <= upper;
+    *exp10 = k;
+    if (u_inside != w_inside) {
+        return s + w_inside;
+    }
+    u64 mid = 4*s + 2;
+    return s + (vb > mid || (vb == mid && (s & 1)));
+}
+
+internal u32 _str_shortest_f32(u32 bits, s32 *exp10) {
+    u32 fraction = bits & ((1u << 23) - 1);
+    s32 biased = (s32) ((bits >> 23) & 0xFF);
+    u32 c;
+    s32 q;
+    if (biased != 0) {
+        c = fraction | (1u << 23);
+        q = biased - 150;
+        if (q <= 0 && q > -24 && (c & ((1u << -q) - 1)) == 0) {
+            *exp10 = 0;
+            return c >> -q;
         }
+    } else {
+        c = fraction;
+        q = -149;
+    }
 
-        s32 got_digit = 0;
-        for (i = 0; i < p.len; i++) {
-            u8 digit = p.str[i] - '0';
-            if (digit >= 10) {
-                break;
-            }
-            got_digit = 1;
-            exp = 10 * exp + digit;
+    s32 even = (c & 1) == 0;
+    s32 closer_below = (fraction == 0 && biased > 1);
+    u32 cbl = 4*c - 2 + closer_below;
+    u32 cb = 4*c;
+    u32 cbr = 4*c + 2;
+
+    s32 k = closer_below? _str_floor_log10_pow2_three_quarters(q) : _str_floor_log10_pow2(q);
+    s32 h = q + _str_floor_log2_pow10(-k) + 1;
+    /* 10^k rounded up to 64 bits */
+    const u64 *g128 = _str_pow10_128[-k - STR_SHORTEST_MIN_POW10];
+    u64 g = g128[0] + (g128[1] != 0);
+    u32 vbl = _str_round_to_odd_f32(g, cbl << h);
+    u32 vb = _str_round_to_odd_f32(g, cb << h);
+    u32 vbr = _str_round_to_odd_f32(g, cbr << h);
+    u32 lower = vbl + !even;
+    u32 upper = vbr - !even;
+
+    u32 s = vb / 4;
+    if (s >= 10) {
+        u32 sp = s / 10;
+        s32 up_inside = lower <= 40*sp;
+        s32 wp_inside = 40*sp + 40 <= upper;
+        if (up_inside != wp_inside) {
+            *exp10 = k + 1;
+            return sp + wp_inside;
         }
-
-        if (!got_digit) {
-            if (failure) *failure = 1;
-            return 0.0;
-        } 
-        
-        exp = (exp * exp_sign);
-    }
-
-    if (is_hex) {
-        exp += 4*exp_offset;
-        while (exp > 0) {
-            f *= 2; exp--;
-            // Goofy ahh optimization attempt
-            if (exp >=+16) { f *= 0x1p+16; exp -= 16; }
-            if (exp >=+8) { f *= 0x1p+8; exp -= 8; }
-            if (exp >=+4) { f *= 0x1p+4; exp -= 4; }
-        }
-        while (exp < 0) {
-            f *= 0.5; exp++;
-            if (exp <=-16) { f *= 0x1p-16; exp += 16; }
-            if (exp <=-8) { f *= 0x1p-8; exp += 8; }
-            if (exp <=-4) { f *= 0x1p-4; exp += 4; }
+    }
+    s32 u_inside = lower <= 4*s;
+    s32 w_inside = 4*s + 4 <= upper;
+    *exp10 = k;
+    if (u_inside != w_inside) {
+        return s + w_inside;
+    }
+    u32 mid = 4*s + 2;
+    return s + (vb > mid || (vb == mid && (s & 1)));
+}
+
+static read_only char _str_digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* Writes the digits of n ending just before end, returns how many */
+internal s32 _str_write_u64_backward(char *end, u64 n) {
+    char *p = end;
+    /* 8 digits at a time in 32 bits, the divides by constants are cheaper there */
+    while (n >= 100000000) {
+        u32 chunk = (u32) (n % 100000000);
+        n /= 100000000;
+        for (s32 i = 0; i < 4; i++) {
+            p -= 2;
+            memcpy(p, _str_digit_pairs + 2*(chunk % 100), 2);
+            chunk /= 100;
         }
+    }
+    u32 m = (u32) n;
+    while (m >= 100) {
+        p -= 2;
+        memcpy(p, _str_digit_pairs + 2*(m % 100), 2);
+        m /= 100;
+    }
+    if (m >= 10) {
+        p -= 2;
+        memcpy(p, _str_digit_pairs + 2*m, 2);
     } else {
-        exp += exp_offset;
-        while (exp > 0) {
-            f *= 10.0; exp--;
-            if (exp >=+16) { f *= 1e+16; exp -= 16; }
-            if (exp >=+8) { f *= 1e+8; exp -= 8; }
-            if (exp >=+4) { f *= 1e+4; exp -= 4; }
+        *--p = (char) ('0' + m);
+    }
+    return (s32) (end - p);
+}
+
+/* Writes digits*10^exp10 like %g with precision max_fixed but with all of the digits: plain
+   notation while the exponent is in [-5, max_fixed), scientific outside. out needs 32 bytes. */
+internal s64 _str_write_shortest(char *out, s32 negative, u64 digits, s32 exp10, s32 max_fixed) {
+    char *p = out;
+    if (negative) {
+        *p++ = '-';
+    }
+    if (digits == 0) {
+        *p++ = '0';
+        return p - out;
+    }
+    while (digits % 10 == 0) {
+        digits /= 10;
+        exp10++;
+    }
+    char buf[24];
+    s32 n = _str_write_u64_backward(buf + sizeof(buf), digits);
+    char *d = buf + sizeof(buf) - n;
+    s32 x = exp10 + n - 1; /* Scientific exponent */
+
+    if (x < -5 || x >= max_fixed) {
+        *p++ = d[0];
+        if (n > 1) {
+            *p++ = '.';
+            memcpy(p, d + 1, n - 1);
+            p += n - 1;
+        }
+        *p++ = 'e';
+        *p++ = (x < 0)? '-' : '+';
+        x = (x < 0)? -x : x;
+        if (x >= 100) {
+            *p++ = (char) ('0' + x/100);
+            x %= 100;
+        }
+        memcpy(p, _str_digit_pairs + 2*x, 2);
+        p += 2;
+    } else if (x < 0) { /* 0.000ddd */
+        *p++ = '0';
+        *p++ = '.';
+        for (s32 i = 0; i < -x - 1; i++) {
+            *p++ = '0';
         }
-        while (exp < 0) {
-            f *= 0.1; exp++;
-            if (exp <=-16) { f *= 1e-16; exp += 16; }
-            if (exp <=-8) { f *= 1e-8; exp += 8; }
-            if (exp <=-4) { f *= 1e-4; exp += 4; }
+        memcpy(p, d, n);
+        p += n;
+    } else if (n <= x + 1) { /* ddd000 */
+        memcpy(p, d, n);
+        p += n;
+        for (s32 i = 0; i < x + 1 - n; i++) {
+            *p++ = '0';
         }
+    } else { /* dd.ddd */
+        memcpy(p, d, x + 1);
+        p += x + 1;
+        *p++ = '.';
+        memcpy(p, d + x + 1, n - x - 1);
+        p += n - x - 1;
     }
+    return p - out;
+}
 
-    if (failure) *failure = 0;
-    return f;
+str str_from_f64_custom(void *memory, f64 f) {
+    str s = { 0, (char*) memory };
+    u64 bits;
+    memcpy(&bits, &f, sizeof(bits));
+    s32 negative = (s32) (bits >> 63);
+    if (((bits >> 52) & 0x7FF) == 0x7FF) {
+        str special = (bits & ((1ull << 52) - 1))? strl("nan") : negative? strl("-inf") : strl("inf");
+        return str_copy_custom(memory, special);
+    }
+    s32 exp10 = 0;
+    u64 digits = (bits << 1)? _str_shortest_f64(bits, &exp10) : 0;
+    s.len = _str_write_shortest(s.str, negative, digits, exp10, 17);
+    return s;
+}
+
+str str_from_f32_custom(void *memory, f32 f) {
+    str s = { 0, (char*) memory };
+    u32 bits;
+    memcpy(&bits, &f, sizeof(bits));
+    s32 negative = (s32) (bits >> 31);
+    if (((bits >> 23) & 0xFF) == 0xFF) {
+        return str_from_f64_custom(memory, (f64) f);
+    }
+    s32 exp10 = 0;
+    u32 digits = (bits << 1)? _str_shortest_f32(bits, &exp10) : 0;
+    s.len = _str_write_shortest(s.str, negative, digits, exp10, 9);
+    return s;
+}
+
+str str_from_f64(Arena *a, f64 f) {
+    str s = str_from_f64_custom(Arena_take(a, STR_FLOAT_CHARS_MAX), f);
+    Arena_shrink(a, s.str, STR_FLOAT_CHARS_MAX, s.len);
+    return s;
+}
+
+str str_from_f32(Arena *a, f32 f) {
+    str s = str_from_f32_custom(Arena_take(a, STR_FLOAT_CHARS_MAX), f);
+    Arena_shrink(a, s.str, STR_FLOAT_CHARS_MAX, s.len);
+    return s;
 }
 
 #undef RET_STR
@@ -927,5 +2566,239 @@ StrList StrList_copy(Arena *a, StrList list) {
     return copy;
 }
 
+/** Ring Buffer                      **/
+Ring Ring_create(s64 size) {
+    Ring r = {0};
+    r.size = KB(64);
+    while (r.size < size) {
+        r.size *= 2;
+    }
+    r.data = (char*) LCF_MEMORY_map_ring((upr) r.size);
+    if (!r.data) {
+        r.size = 0;
+    }
+    return r;
+}
+
+void Ring_destroy(Ring *r) {
+    if (r->data) {
+        LCF_MEMORY_unmap_ring(r->data, (upr) r->size);
+    }
+    Ring zero = {0};
+    *r = zero;
+}
+
+/* NOTE(lcf) Each side reads its own counter plainly and the other side's atomically. */
+str Ring_read_view(Ring *r) {
+    u64 write = ATOMIC_LOAD_U64(&r->write);
+    str s = { (s64)(write - r->read), r->data + (r->read & (r->size-1)) };
+    return s;
+}
+
+void Ring_consume(Ring *r, s64 len) {
+    ASSERT(len >= 0 && (u64) len <= ATOMIC_LOAD_U64(&r->write) - r->read);
+    ATOMIC_STORE_U64(&r->read, r->read + len);
+}
+
+void Ring_consume_to(Ring *r, str view, str rest) {
+    Ring_consume(r, view.len - rest.len);
+}
+
+str Ring_write_space(Ring *r) {
+    u64 read = ATOMIC_LOAD_U64(&r->read);
+    str s = { r->size - (s64)(r->write - read), r->data + (r->write & (r->size-1)) };
+    return s;
+}
+
+void Ring_commit(Ring *r, s64 len) {
+    ASSERT(len >= 0 && (u64) len <= r->size - (r->write - ATOMIC_LOAD_U64(&r->read)));
+    ATOMIC_STORE_U64(&r->write, r->write + len);
+}
+
+s64 Ring_write(Ring *r, str s) {
+    str space = Ring_write_space(r);
+    s64 len = MIN(s.len, space.len);
+    memcpy(space.str, s.str, len);
+    Ring_commit(r, len);
+    return len;
+}
+
+/** Multi-Pattern Matching           **/
+StrMatcher* StrMatcher_create(Arena *a, str *patterns, u32 count) {
+    u64 start = Arena_pos(a);
+    StrMatcher *m = Arena_take_struct_zero(a, StrMatcher);
+    u32 classes = 1; /* Class 0 is every byte not in a pattern */
+    u64 total = 0;
+    for (u32 i = 0; i < count; i++) {
+        str_iter(patterns[i], j, ch) {
+            u8 b = (u8) ch;
+            /* With all 256 bytes in patterns the last one takes class 0, which is then its own */
+            if (!m->byte_class[b] && classes < 256) {
+                m->byte_class[b] = (u8) classes++;
+            }
+        }
+        total += patterns[i].len;
+    }
+    u64 max_states = total + 1;
+    if (max_states*classes > (u64) STR_MATCHER_NONE) {
+        Arena_reset(a, start);
+        return 0;
+    }
+    m->classes = classes;
+    m->pattern_count = count;
+    m->pattern_next = Arena_take_array(a, u32, count);
+    m->pattern_len = Arena_take_array(a, u32, count);
+
+    ArenaSession scratch = Scratch_session_custom(&a, 1);
+    Arena *t = scratch.arena;
+    u32 *go = Arena_take_array_zero(t, u32, max_states*classes); /* Trie, 0 is no edge */
+    u32 *own = Arena_take_array(t, u32, max_states);
+    u32 *fail = Arena_take_array(t, u32, max_states);
+    u32 *dict = Arena_take_array(t, u32, max_states);
+    u32 *order = Arena_take_array(t, u32, max_states);
+    u32 *renumber = Arena_take_array(t, u32, max_states);
+    memset(own, 0xff, max_states*sizeof(u32));
+
+    /* Build the trie backwards so the patterns of a state chain up in index order */
+    u32 states = 1;
+    for (u32 i = count; i-- > 0; ) {
+        m->pattern_len[i] = (u32) patterns[i].len;
+        m->pattern_next[i] = STR_MATCHER_NONE;
+        if (str_is_empty(patterns[i])) {
+            continue;
+        }
+        u32 s = 0;
+        str_iter(patterns[i], j, ch) {
+            u32 *edge = go + (u64) s*classes + m->byte_class[(u8) ch];
+            if (!*edge) {
+                *edge = states++;
+            }
+            s = *edge;
+        }
+        m->pattern_next[i] = own[s];
+        own[s] = i;
+    }
+
+    /* Breadth first, fill in the failure links and fold them into the table */
+    u32 head = 0, tail = 0;
+    order[tail++] = 0;
+    fail[0] = 0;
+    dict[0] = STR_MATCHER_NONE;
+    while (head < tail) {
+        u32 s = order[head++];
+        u32 *row = go + (u64) s*classes;
+        u32 *fail_row = go + (u64) fail[s]*classes;
+        for (u32 k = 0; k < classes; k++) {
+            u32 child = row[k];
+            if (!child) {
+                row[k] = (s == 0)? 0 : fail_row[k];
+                continue;
+            }
+            u32 f = (s == 0)? 0 : fail_row[k];
+            fail[child] = f;
+            dict[child] = (own[f] != STR_MATCHER_NONE)? f : dict[f];
+            order[tail++] = child;
+        }
+    }
+
+    /* States without a match first, in breadth first order, then the ones with a match */
+    u32 n = 0;
+    for (u32 i = 0; i < states; i++) {
+        u32 s = order[i];
+        if (own[s] == STR_MATCHER_NONE && dict[s] == STR_MATCHER_NONE) {
+            renumber[s] = n++;
+        }
+    }
+    m->match_state = n*classes;
+    for (u32 i = 0; i < states; i++) {
+        u32 s = order[i];
+        if (own[s] != STR_MATCHER_NONE || dict[s] != STR_MATCHER_NONE) {
+            renumber[s] = n++;
+        }
+    }
+
+    m->states = states;
+    m->next = Arena_take_array(a, u32, (u64) states*classes);
+    m->pattern = Arena_take_array(a, u32, states);
+    m->suffix = Arena_take_array(a, u32, states);
+    for (u32 s = 0; s < states; s++) {
+        u32 r = renumber[s];
+        u32 *row = go + (u64) s*classes;
+        u32 *out = m->next + (u64) r*classes;
+        for (u32 k = 0; k < classes; k++) {
+            out[k] = renumber[row[k]]*classes;
+        }
+        m->pattern[r] = own[s];
+        m->suffix[r] = (dict[s] == STR_MATCHER_NONE)? STR_MATCHER_NONE : renumber[dict[s]]*classes;
+    }
+    ArenaSession_end(scratch);
+    return m;
+}
+
+StrMatchIter StrMatcher_begin(StrMatcher *m, str s) {
+    StrMatchIter it = ZERO_STRUCT;
+    it.matcher = m;
+    it.chunk = s;
+    it.out_pattern = STR_MATCHER_NONE;
+    return it;
+}
+
+void StrMatchIter_feed(StrMatchIter *it, str chunk) {
+    it->pos += it->chunk.len;
+    it->chunk = chunk;
+    it->i = 0;
+}
+
+/* Moves to the first pattern of state, or down the suffix links to one that has a pattern */
+internal void _StrMatchIter_output(StrMatchIter *it, u32 state) {
+    StrMatcher *m = it->matcher;
+    it->out_pattern = STR_MATCHER_NONE;
+    while (state != STR_MATCHER_NONE) {
+        it->out_state = state;
+        it->out_pattern = m->pattern[state/m->classes];
+        if (it->out_pattern != STR_MATCHER_NONE) {
+            break;
+        }
+        state = m->suffix[state/m->classes];
+    }
+}
+
+s32 StrMatchIter_next(StrMatchIter *it, StrMatch *match) {
+    StrMatcher *m = it->matcher;
+    if (it->out_pattern == STR_MATCHER_NONE) {
+        u8 *bytes = (u8*) it->chunk.str;
+        u32 *next = m->next;
+        u8 *byte_class = m->byte_class;
+        u32 match_state = m->match_state;
+        u32 s = it->state;
+        s64 i = it->i;
+        s64 len = it->chunk.len;
+        s32 found = false;
+        while (i < len) {
+            s = next[s + byte_class[bytes[i++]]];
+            if (s >= match_state) {
+                found = true;
+                break;
+            }
+        }
+        it->state = s;
+        it->i = i;
+        if (!found) {
+            return false;
+        }
+        _StrMatchIter_output(it, s);
+    }
+
+    u32 p = it->out_pattern;
+    match->pattern = p;
+    match->len = m->pattern_len[p];
+    match->offset = it->pos + it->i - match->len;
+    it->out_pattern = m->pattern_next[p];
+    if (it->out_pattern == STR_MATCHER_NONE) {
+        _StrMatchIter_output(it, m->suffix[it->out_state/m->classes]);
+    }
+    return true;
+}
+
 
 /** ******************************** **/
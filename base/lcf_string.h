@@ -15,6 +15,61 @@ typedef struct str str;
 
 #define str_PRINTF_ARGS(s) (int)(s).len, (s).str
 
+/* Searches use SSE2 on x64, or AVX2 when the compiler targets it (-mavx2, /arch:AVX2). Set
+   LCF_STRING_SIMD to 0 for plain C. The SIMD loops only do aligned loads, which never cross
+   into an unmapped page, but they read bytes just outside the str. So sanitizers are turned
+   off for those functions. */
+#define LCF_STRING_SSE2 1
+#define LCF_STRING_AVX2 2
+#if !defined(LCF_STRING_SIMD)
+ #if defined(__AVX2__)
+  #define LCF_STRING_SIMD LCF_STRING_AVX2
+ #elif ARCH_X64 || defined(__SSE2__)
+  #define LCF_STRING_SIMD LCF_STRING_SSE2
+ #else
+  #define LCF_STRING_SIMD 0
+ #endif
+#endif
+/* Charset searches shuffle nibbles with pshufb, which needs SSSE3. On by default with AVX2 or
+   when the compiler targets SSSE3 (-mssse3), otherwise it is a table lookup per byte. */
+#if !defined(LCF_STRING_SHUFFLE)
+ #if LCF_STRING_SIMD == LCF_STRING_AVX2 || (LCF_STRING_SIMD && defined(__SSSE3__))
+  #define LCF_STRING_SHUFFLE 1
+ #else
+  #define LCF_STRING_SHUFFLE 0
+ #endif
+#endif
+/* str_to_u64 parses 16 digits at a time with SSE4.1 when the compiler targets it (-msse4.1)
+   or AVX2, otherwise 8 at a time in a u64. */
+#if !defined(LCF_STRING_SSE41)
+ #if LCF_STRING_SIMD == LCF_STRING_AVX2 || (LCF_STRING_SIMD && defined(__SSE4_1__))
+  #define LCF_STRING_SSE41 1
+ #else
+  #define LCF_STRING_SSE41 0
+ #endif
+#endif
+/* Longest substring searched for with the SIMD filter, longer ones use Two-Way */
+#if !defined(LCF_STRING_SHORT_NEEDLE)
+ #define LCF_STRING_SHORT_NEEDLE 32
+#endif
+
+/* A str that can live in a file Arena, see RelPtr */
+struct RelStr {
+    RelPtr str;
+    s64 len;
+};
+typedef struct RelStr RelStr;
+
+static inline str RelStr_get(RelStr *r) {
+    str s = { r->len, (char*) RelPtr_get(&r->str) };
+    return s;
+}
+
+static inline void RelStr_set(RelStr *r, str s) {
+    RelPtr_set(&r->str, s.str);
+    r->len = s.len;
+}
+
 /* Create strs */
 str str_from(char* s, s64 len);
 str str_from_pointer_range(char *p1, char *p2);
@@ -65,6 +120,26 @@ s64 str_first_whitespace_location(str s);
 char char_lower(char c);
 char char_upper(char c);
 
+/* Charsets
+   A set of bytes, like delims but built once and reused. The search tests a whole vector
+   against the set, so it costs the same for 2 or 200 members. bits is the plain 256 bit set,
+   low and high are the same bits arranged by nibble for the shuffle: bit (b >> 4) of
+   low[b & 15] for bytes below 128, bit (b >> 4) - 8 of high[b & 15] for the rest. */
+struct StrCharset {
+    u64 bits[4];
+    u8 low[16];
+    u8 high[16];
+};
+typedef struct StrCharset StrCharset;
+
+StrCharset StrCharset_from(str chars);
+void StrCharset_add(StrCharset *set, char c);
+static inline s32 StrCharset_has(StrCharset *set, char c) {
+    u8 b = (u8) c;
+    return (s32) ((set->bits[b >> 6] >> (b & 63)) & 1);
+}
+s64 str_charset_location(str s, StrCharset *set);
+
 /* Conditional Operations */
 str str_trim_prefix(str s, str prefix);
 str str_trim_suffix(str s, str suffix);
@@ -77,21 +152,38 @@ str str_trim_last_slash(str s);
 str str_trim_file_type(str s);
 str str_get_file_type(str s);
 
-/* Parsing */
+/* Parsing
+   str_to_u64 reads 0x hex, 0b binary and 0 octal prefixes, and stops at the first non digit.
+   Digits past what fits in a u64 are ignored. str_count_digits is the length of the run of
+   base 2, 8, 10 or 16 digits at the start of s, upper or lower case for hex. */
 u64 str_to_u64(str s, s32 *failure);
 s64 str_to_s64(str s, s32 *failure);
 f64 str_to_f64(str s, s32 *failure);
+s64 str_count_digits(str s, s32 base);
 
-/* Iterations */
+/* Formatting floats
+   The fewest digits that str_to_f64 (or strtod) reads back as exactly the same value, so
+   saving and loading never drifts. Plain notation for exponents in [-5, 17), or [-5, 9) for
+   f32, scientific outside that, eg. 0.1, 1.5e-07, 123456, 1e+21. inf, -inf and nan as is.
+   f32s keep their own shortest digits, str_from_f32(a, 0.1f) is 0.1 where str_from_f64 gives
+   0.10000000149011612. To use in strf pass the result with "%.*s" and str_PRINTF_ARGS. */
+#define STR_FLOAT_CHARS_MAX 32
+str str_from_f64(Arena *a, f64 f);
+str str_from_f32(Arena *a, f32 f);
+str str_from_f64_custom(void *memory, f64 f); /* memory needs STR_FLOAT_CHARS_MAX bytes */
+str str_from_f32_custom(void *memory, f32 f);
+
+/* Iterations
+   NOTE(lcf) c is loaded after the bounds check, never touching memory outside of s. */
 #define str_iter(s, i, c)                           \
     s64 i = 0;                                              \
-    char c = s.str? s.str[i] : 0;                                      \
-    for (; (i < (s64) s.len); i++, c = s.str[i])
+    char c = 0;                                             \
+    for (; (i < (s64) s.len) && ((c = s.str[i]), 1); i++)
 
 #define str_iter_backward(s, i, c)                  \
     s64 i = s.len-1;                                        \
-    char c = s.str[i];                                      \
-    for (; (i >= 0); i--, c = s.str[i])
+    char c = 0;                                             \
+    for (; (i >= 0) && ((c = s.str[i]), 1); i--)
 
 /* The idea of these procedures is to search the string for a search_str(substring|delimiter|whitespace),
    then return the substring before the search_str, as well as advancing src to be past the search_str.
@@ -106,6 +198,7 @@ f64 str_to_f64(str s, s32 *failure);
 /* WARN(lcf): These modify the src struct (not the data though). */
 str str_pop_at_first_substring(str *src, str split_by);
 str str_pop_at_first_delimiter(str *src, str delims);
+str str_pop_at_first_charset(str *src, StrCharset *set);
 str str_pop_at_first_whitespace(str *src);
 
 #define str_iter_substring(s, split_by, iter)               \
@@ -130,6 +223,16 @@ str str_pop_at_first_whitespace(str *src);
         iter = str_pop_at_first_delimiter(&MACRO_VAR(_str),MACRO_VAR(_delims)) \
         )
         
+#define str_iter_charset(s, set, iter)            \
+    for (                                                               \
+        str MACRO_VAR(_str) = (s),                                          \
+            iter = str_pop_at_first_charset(&MACRO_VAR(_str),(set))     \
+            ;                                                           \
+        (!str_is_empty(iter) || !str_is_empty(MACRO_VAR(_str)))                      \
+            ;                                                           \
+        iter = str_pop_at_first_charset(&MACRO_VAR(_str),(set))         \
+        )
+
 global str str_NEWLINE = {1, "\n"};
 #define str_iter_line(s, l) str_iter_delimiter(s, str_NEWLINE, l)
 
@@ -189,6 +292,94 @@ typedef struct StrJoin StrJoin;
 str StrList_join(Arena *a, StrList list, StrJoin join);
 StrList StrList_copy(Arena *a, StrList list);
 
+/** Ring Buffer                      **/
+/* A byte queue for streaming input. The memory is mapped twice back to back (see
+   LCF_MEMORY_map_ring), so the unread data and the free space are each one contiguous str even
+   when they wrap around the end. Parsers can run over Ring_read_view directly without copying
+   at the boundary.
+
+   The producer writes into Ring_write_space and then commits what it wrote. The consumer parses
+   Ring_read_view and then consumes what it used. One producer and one consumer can be on
+   different threads.
+ */
+struct Ring {
+    char *data;
+    s64 size; /* Power of 2, at least KB(64) */
+    u64 read; /* Total bytes consumed */
+    u64 write; /* Total bytes committed */
+};
+typedef struct Ring Ring;
+
+Ring Ring_create(s64 size); /* Rounds size up, data is 0 if the memory can't be mapped */
+void Ring_destroy(Ring *r);
+str Ring_read_view(Ring *r);
+void Ring_consume(Ring *r, s64 len);
+void Ring_consume_to(Ring *r, str view, str rest); /* Consume what str_pop_* took from view to leave rest */
+str Ring_write_space(Ring *r);
+void Ring_commit(Ring *r, s64 len);
+s64 Ring_write(Ring *r, str s); /* Copies as much of s as fits, returns the bytes copied */
+
+/** Multi-Pattern Matching           **/
+/* Aho-Corasick. StrMatcher_create builds all the patterns into one automaton, then a single
+   pass over the input finds every occurrence of every pattern, overlapping ones included, with
+   the same work per byte however many patterns there are.
+
+   Bytes that appear in no pattern share one class, so the transition table has a column per
+   distinct pattern byte instead of 256. Failure links are folded into the table, so each input
+   byte is two loads. States are numbered breadth first so the common shallow states sit
+   together, with the states that report a match moved to the end: checking for a match is a
+   single compare against match_state.
+
+   Input can be fed in chunks, eg. from a Ring. Match offsets count from the start of the stream,
+   and a match can span chunks (its start is then in an earlier chunk).
+
+   REF(lcf) Aho, Corasick. Efficient string matching. CACM 18(6), 1975.
+ */
+#define STR_MATCHER_NONE (~0u)
+
+struct StrMatcher {
+    u8 byte_class[256];
+    u32 classes;
+    u32 states;
+    u32 match_state; /* States at or past this have a match, in the units of next */
+    u32 pattern_count;
+    u32 *next; /* [states*classes], next[state + class], entries are premultiplied by classes */
+    u32 *pattern; /* [states], first pattern ending at a state, by state/classes */
+    u32 *suffix; /* [states], longest proper suffix state that has a pattern, premultiplied */
+    u32 *pattern_next; /* [pattern_count], next pattern with the same text */
+    u32 *pattern_len; /* [pattern_count] */
+};
+typedef struct StrMatcher StrMatcher;
+
+struct StrMatch {
+    u32 pattern; /* Index into the patterns given to StrMatcher_create */
+    s64 offset; /* Of the first byte, from the start of the stream */
+    s64 len;
+};
+typedef struct StrMatch StrMatch;
+
+struct StrMatchIter {
+    StrMatcher *matcher;
+    str chunk;
+    s64 i; /* Next byte of chunk */
+    s64 pos; /* Stream offset of chunk */
+    u32 state;
+    u32 out_state; /* State whose matches are being returned */
+    u32 out_pattern; /* Next pattern to return, STR_MATCHER_NONE when done */
+};
+typedef struct StrMatchIter StrMatchIter;
+
+/* Empty patterns never match. Returns 0 if the table wouldn't fit u32 indices. */
+StrMatcher* StrMatcher_create(Arena *a, str *patterns, u32 count);
+StrMatchIter StrMatcher_begin(StrMatcher *m, str s);
+void StrMatchIter_feed(StrMatchIter *it, str chunk); /* Continue the stream with the next chunk */
+s32 StrMatchIter_next(StrMatchIter *it, StrMatch *match); /* Returns 0 once the chunk is used up */
+
+/* Every match in s, in order of where they end. match is a StrMatch declared by the caller. */
+#define str_iter_matches(m, s, match)                                  \
+    for (StrMatchIter MACRO_VAR(_it) = StrMatcher_begin((m), (s));    \
+         StrMatchIter_next(&MACRO_VAR(_it), &(match)); )
+
 /** Unicode                          **/
 /* TODO(lcf) */
 
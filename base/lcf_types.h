@@ -73,6 +73,30 @@
     #define BADPATH(M) ASSERTM(0, M)
 #endif
 
+/* Atomics
+   NOTE(lcf): All of these are full barriers. ATOMIC_ADD and ATOMIC_EXCHANGE return the value
+   before, ATOMIC_CAS returns whether the swap happened. */
+#if COMPILER_CL
+ #include <intrin.h>
+ #define ATOMIC_LOAD_U64(p) ((u64)_InterlockedOr64((volatile __int64*)(p), 0))
+ #define ATOMIC_STORE_U64(p,v) ((void)_InterlockedExchange64((volatile __int64*)(p), (__int64)(v)))
+ #define ATOMIC_EXCHANGE_U64(p,v) ((u64)_InterlockedExchange64((volatile __int64*)(p), (__int64)(v)))
+ #define ATOMIC_ADD_U64(p,v) ((u64)_InterlockedExchangeAdd64((volatile __int64*)(p), (__int64)(v)))
+ #define ATOMIC_CAS_U64(p,expected,desired) ((u64)_InterlockedCompareExchange64((volatile __int64*)(p), (__int64)(desired), (__int64)(expected)) == (u64)(expected))
+ #define CPU_PAUSE() _mm_pause()
+#elif COMPILER_CLANG || COMPILER_GCC
+ #define ATOMIC_LOAD_U64(p) __atomic_load_n((u64*)(p), __ATOMIC_SEQ_CST)
+ #define ATOMIC_STORE_U64(p,v) __atomic_store_n((u64*)(p), (u64)(v), __ATOMIC_SEQ_CST)
+ #define ATOMIC_EXCHANGE_U64(p,v) __atomic_exchange_n((u64*)(p), (u64)(v), __ATOMIC_SEQ_CST)
+ #define ATOMIC_ADD_U64(p,v) __atomic_fetch_add((u64*)(p), (u64)(v), __ATOMIC_SEQ_CST)
+ #define ATOMIC_CAS_U64(p,expected,desired) __sync_bool_compare_and_swap((u64*)(p), (u64)(expected), (u64)(desired))
+ #if ARCH_X64 || ARCH_X86
+  #define CPU_PAUSE() __builtin_ia32_pause()
+ #else
+  #define CPU_PAUSE() ((void)0)
+ #endif
+#endif
+
 /* Misc */
 #define ARRAY_LENGTH(A) (sizeof(A)/sizeof(*(A)))
 #define PTR_TO_INT(P) (unsigned long long)((char*)P - (char*)0)
@@ -135,5 +159,34 @@ typedef double f64;
 typedef intptr_t spr;
 typedef uintptr_t upr;
 
+/* Bit scans
+   NOTE(lcf): Index of the lowest/highest set bit, x must not be 0. */
+#if COMPILER_CL
+static inline u32 bit_scan_forward_u64(u64 x) { unsigned long i; _BitScanForward64(&i, x); return (u32) i; }
+static inline u32 bit_scan_reverse_u64(u64 x) { unsigned long i; _BitScanReverse64(&i, x); return (u32) i; }
+#elif COMPILER_CLANG || COMPILER_GCC
+static inline u32 bit_scan_forward_u64(u64 x) { return (u32) __builtin_ctzll(x); }
+static inline u32 bit_scan_reverse_u64(u64 x) { return 63 - (u32) __builtin_clzll(x); }
+#endif
+
+/* Full 64x64 bit multiply, returns the low half and stores the high half in hi */
+#if COMPILER_CL && ARCH_X64
+static inline u64 mul_u64_wide(u64 a, u64 b, u64 *hi) { return _umul128(a, b, hi); }
+#elif (COMPILER_CLANG || COMPILER_GCC) && defined(__SIZEOF_INT128__)
+static inline u64 mul_u64_wide(u64 a, u64 b, u64 *hi) {
+    unsigned __int128 p = (unsigned __int128) a * b;
+    *hi = (u64) (p >> 64);
+    return (u64) p;
+}
+#else
+static inline u64 mul_u64_wide(u64 a, u64 b, u64 *hi) {
+    u64 a_lo = (u32) a, a_hi = a >> 32, b_lo = (u32) b, b_hi = b >> 32;
+    u64 lo_lo = a_lo*b_lo, hi_lo = a_hi*b_lo, lo_hi = a_lo*b_hi, hi_hi = a_hi*b_hi;
+    u64 cross = (lo_lo >> 32) + (u32) hi_lo + lo_hi;
+    *hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (u32) lo_lo;
+}
+#endif
+
 /** ******************************** **/
 #endif
@@ -116,9 +116,10 @@ u64 os_GetFileTime() {
 u64 os_GetTimeMicroseconds(void) {
     u64 result = 0;
 
+    /* Monotonic like QueryPerformanceCounter on win32, tv_nsec alone wraps every second */
     struct timespec time;
-    if (clock_gettime(CLOCK_REALTIME, &time) == 0) {
-        result = time.tv_nsec;
+    if (clock_gettime(CLOCK_MONOTONIC, &time) == 0) {
+        result = (u64) time.tv_sec*1000000 + (u64) time.tv_nsec/1000;
     }
         
     return result;
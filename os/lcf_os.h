@@ -8,6 +8,19 @@
 #define LCF_MEMORY_commit os_Commit
 #define LCF_MEMORY_decommit os_Decommit
 #define LCF_MEMORY_free os_Free
+#define LCF_MEMORY_reserve_large os_ReserveLarge
+#define LCF_MEMORY_prefault os_Prefault
+#define LCF_MEMORY_protect os_Protect
+#define LCF_MEMORY_map_file os_MapFile
+#define LCF_MEMORY_unmap_file os_UnmapFile
+#define LCF_MEMORY_map_ring os_MapRing
+#define LCF_MEMORY_unmap_ring os_UnmapRing
+#define LCF_MEMORY_watch_writes os_WatchWrites
+#define LCF_MEMORY_protect_writes os_ProtectWrites
+#define LCF_MEMORY_bind_node os_NumaBind
+#define LCF_MEMORY_current_node os_NumaCurrentNode
+#define LCF_MEMORY_page_nodes os_NumaPageNodes
+#define LCF_MEMORY_LARGE_PAGE_SIZE (os_GetLargePageSize())
 #define LCF_MEMORY_RESERVE_SIZE (MB(256))
 #define LCF_MEMORY_COMMIT_SIZE (os_GetPageSize())
 
@@ -22,6 +35,23 @@ void* os_Reserve(upr size);
 s32 os_Commit(void *memory, upr size);
 void os_Decommit(void *memory, upr size);
 void os_Free(void *memory, upr size);
+u64 os_GetLargePageSize();
+void* os_ReserveLarge(upr size); /* Returns 0 if large pages are unavailable, always on win32 */
+void os_Prefault(void *memory, upr size); /* Fault in committed memory */
+s32 os_Protect(void *memory, upr size); /* Make committed memory inaccessible until it is committed again */
+void* os_MapFile(char *path, upr size); /* Shared read/write mapping of size bytes, grows the file if needed */
+void os_UnmapFile(char *path, void *memory, upr size, upr file_size); /* Also cuts the file to file_size */
+void* os_MapRing(upr size); /* size bytes mapped twice back to back, see Ring */
+void os_UnmapRing(void *memory, upr size);
+s32 os_WatchWrites(void *memory, upr size, upr page_size, u64 *dirty); /* See LCF_MEMORY_WATCH_WRITES */
+void os_ProtectWrites(void *memory, upr size, s32 writable);
+
+/* NUMA, see LCF_MEMORY_BIND_NODE. Single node machines report a node count of 1 and the rest
+   do nothing. */
+u32 os_NumaNodeCount(void);
+s32 os_NumaBind(void *memory, upr size, u32 node); /* Returns 0 if it can't, always on win32 */
+s32 os_NumaCurrentNode(void);
+s32 os_NumaPageNodes(void **pages, u64 count, s32 *nodes);
 
 /* File System */
 enum os_file_flags {
@@ -86,8 +116,19 @@ u64 os_GetFileTime(void);
 u64 os_GetTimeMicroseconds(void);
 u64 os_GetTimeCycles(void);
 
-/* Threading */
+/* Threading
+   New threads get their own scratch arenas before proc runs. */
+#define OS_THREAD_PROC(name) void name(void *data)
+typedef OS_THREAD_PROC(os_ThreadProc);
+struct os_Thread {
+    os_ThreadProc *proc;
+    void *data;
+    u64 handle;
+};
+typedef struct os_Thread os_Thread;
 u64 os_GetThreadID(void);
+s32 os_ThreadStart(os_Thread *thread, os_ThreadProc *proc, void *data); /* thread must stay valid until joined */
+void os_ThreadJoin(os_Thread *thread);
 
 #endif /* LCF_OS */
 
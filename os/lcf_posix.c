@@ -27,10 +27,287 @@ void os_Decommit(void *memory, upr size) {
     madvise(memory, size, MADV_DONTNEED);
 }
 
+s32 os_Protect(void *memory, upr size) {
+    s32 result = mprotect(memory, size, PROT_NONE);
+    return result == 0;
+}
+
 void os_Free(void *memory, upr size) {
     munmap(memory, size);    
 }
 
+void* os_MapFile(char *path, upr size) {
+    void *result = 0;
+    s32 fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && ((upr) st.st_size >= size || ftruncate(fd, size) == 0)) {
+            result = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t) 0);
+            if (result == MAP_FAILED) {
+                result = 0;
+            }
+        }
+        close(fd); /* The mapping keeps the file open */
+    }
+    return result;
+}
+
+void os_UnmapFile(char *path, void *memory, upr size, upr file_size) {
+    munmap(memory, size);
+    if (truncate(path, file_size) != 0) {
+        /* NOTE(lcf) the file is just left bigger than needed */
+    }
+}
+
+void* os_MapRing(upr size) {
+    void *result = 0;
+    #if OS_LINUX
+    s32 fd = (s32) syscall(SYS_memfd_create, "lcf_ring", 0);
+    #else
+    char name[64];
+    stbsp_snprintf(name, sizeof(name), "/lcf_ring_%d_%p", (s32) getpid(), (void*) &size);
+    s32 fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name);
+    }
+    #endif
+    if (fd >= 0) {
+        if (ftruncate(fd, size) == 0) {
+            u8 *base = (u8*) mmap(0, 2*size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, (off_t) 0);
+            if (base != MAP_FAILED) {
+                /* MAP_FIXED replaces the reservation, so nothing else can land in the gap */
+                void *lo = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, (off_t) 0);
+                void *hi = mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, (off_t) 0);
+                if (lo == base && hi == base + size) {
+                    result = base;
+                } else {
+                    munmap(base, 2*size);
+                }
+            }
+        }
+        close(fd); /* The mappings keep the memory alive */
+    }
+    return result;
+}
+
+void os_UnmapRing(void *memory, upr size) {
+    munmap(memory, 2*size);
+}
+
+/* Write watching
+   Write faults on a watched range are handled by setting the page's dirty bit and making it
+   writable. Anything else goes on to the handler that was installed before. The handler only
+   reads the table, and start is set last so it never sees a half filled entry. */
+#define POSIX_WATCH_MAX 64
+struct posix_Watch {
+    u64 start;
+    u64 end;
+    u64 page_size;
+    u64 *dirty;
+};
+global struct posix_Watch posix_watches[POSIX_WATCH_MAX];
+global u64 posix_watch_lock;
+global s32 posix_watch_installed;
+global struct sigaction posix_watch_old_segv;
+global struct sigaction posix_watch_old_bus;
+
+internal void posix_WriteFault(int sig, siginfo_t *info, void *context) {
+    u64 address = (u64) info->si_addr;
+    for (s32 i = 0; i < POSIX_WATCH_MAX; i++) {
+        struct posix_Watch *w = posix_watches + i;
+        u64 start = ATOMIC_LOAD_U64(&w->start);
+        if (start && address >= start && address < ATOMIC_LOAD_U64(&w->end)) {
+            u64 page = (address - start) / w->page_size;
+            u64 *word = w->dirty + (page >> 6);
+            u64 old = ATOMIC_LOAD_U64(word);
+            while (!ATOMIC_CAS_U64(word, old, old | (1ull << (page & 63)))) {
+                old = ATOMIC_LOAD_U64(word);
+            }
+            mprotect((void*)(start + page * w->page_size), w->page_size, PROT_READ | PROT_WRITE);
+            return;
+        }
+    }
+
+    struct sigaction *old = (sig == SIGBUS)? &posix_watch_old_bus : &posix_watch_old_segv;
+    if (old->sa_flags & SA_SIGINFO) {
+        old->sa_sigaction(sig, info, context);
+    } else if (old->sa_handler == SIG_DFL || old->sa_handler == SIG_IGN) {
+        /* Returning retries the access, which now faults with the default action */
+        signal(sig, SIG_DFL);
+    } else {
+        old->sa_handler(sig);
+    }
+}
+
+s32 os_WatchWrites(void *memory, upr size, upr page_size, u64 *dirty) {
+    while (!ATOMIC_CAS_U64(&posix_watch_lock, 0, 1)) {
+        CPU_PAUSE();
+    }
+    if (!posix_watch_installed) {
+        struct sigaction action = {0};
+        action.sa_sigaction = posix_WriteFault;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGSEGV, &action, &posix_watch_old_segv);
+        sigaction(SIGBUS, &action, &posix_watch_old_bus); /* mac reports protection faults as SIGBUS */
+        posix_watch_installed = 1;
+    }
+
+    s32 result = 0;
+    struct posix_Watch *free_slot = 0;
+    for (s32 i = 0; i < POSIX_WATCH_MAX && !result; i++) {
+        struct posix_Watch *w = posix_watches + i;
+        if (w->start == (u64) memory) {
+            if (size) {
+                ATOMIC_STORE_U64(&w->end, (u64) memory + size);
+            } else {
+                ATOMIC_STORE_U64(&w->start, 0);
+            }
+            result = 1;
+        } else if (!w->start && !free_slot) {
+            free_slot = w;
+        }
+    }
+    if (!result && size && free_slot) {
+        free_slot->page_size = page_size;
+        free_slot->dirty = dirty;
+        ATOMIC_STORE_U64(&free_slot->end, (u64) memory + size);
+        ATOMIC_STORE_U64(&free_slot->start, (u64) memory);
+        result = 1;
+    }
+
+    ATOMIC_STORE_U64(&posix_watch_lock, 0);
+    return result;
+}
+
+void os_ProtectWrites(void *memory, upr size, s32 writable) {
+    mprotect(memory, size, writable? PROT_READ | PROT_WRITE : PROT_READ);
+}
+
+/* NUMA through raw syscalls, so there is no libnuma dependency */
+#define POSIX_NUMA_MAX_NODES 1024
+#define POSIX_MPOL_PREFERRED 1
+#define POSIX_MPOL_F_MEMS_ALLOWED 4
+global u32 posix_numa_nodes;
+
+u32 os_NumaNodeCount(void) {
+    if (!posix_numa_nodes) {
+        u32 nodes = 1;
+        #if OS_LINUX
+        u64 mask[POSIX_NUMA_MAX_NODES/64] = {0};
+        s32 mode = 0;
+        if (syscall(SYS_get_mempolicy, &mode, mask, (u64) POSIX_NUMA_MAX_NODES, 0, (u64) POSIX_MPOL_F_MEMS_ALLOWED) == 0) {
+            /* Highest allowed node + 1, so node numbers can be used as indices */
+            for (u32 i = 0; i < POSIX_NUMA_MAX_NODES/64; i++) {
+                if (mask[i]) {
+                    nodes = i*64 + (u32) bit_scan_reverse_u64(mask[i]) + 1;
+                }
+            }
+        }
+        #endif
+        posix_numa_nodes = nodes;
+    }
+    return posix_numa_nodes;
+}
+
+s32 os_NumaBind(void *memory, upr size, u32 node) {
+    s32 result = 0;
+    #if OS_LINUX
+    if (os_NumaNodeCount() > 1 && node < os_NumaNodeCount()) {
+        /* Preferred rather than bound, so a full node falls back to the others */
+        u64 mask[POSIX_NUMA_MAX_NODES/64] = {0};
+        mask[node/64] = 1ull << (node % 64);
+        result = syscall(SYS_mbind, memory, size, POSIX_MPOL_PREFERRED, mask, (u64) POSIX_NUMA_MAX_NODES, 0) == 0;
+    }
+    #else
+    (void) memory;
+    (void) size;
+    (void) node;
+    #endif
+    return result;
+}
+
+s32 os_NumaCurrentNode(void) {
+    s32 result = -1;
+    #if OS_LINUX
+    u32 cpu = 0, node = 0;
+    if (os_NumaNodeCount() > 1 && syscall(SYS_getcpu, &cpu, &node, 0) == 0) {
+        result = (s32) node;
+    }
+    #endif
+    return result;
+}
+
+s32 os_NumaPageNodes(void **pages, u64 count, s32 *nodes) {
+    s32 result = 0;
+    #if OS_LINUX
+    /* With no target nodes move_pages only reports where each page is, negative if absent */
+    result = syscall(SYS_move_pages, 0, count, pages, 0, nodes, 0) == 0;
+    for (u64 i = 0; result && i < count; i++) {
+        nodes[i] = MAX(nodes[i], -1);
+    }
+    #else
+    (void) pages;
+    (void) count;
+    (void) nodes;
+    #endif
+    return result;
+}
+
+#if OS_LINUX && !defined(MADV_POPULATE_WRITE)
+#define MADV_POPULATE_WRITE 23
+#endif
+
+void os_Prefault(void *memory, upr size) {
+    s32 populated = 0;
+    #if OS_LINUX
+    populated = madvise(memory, size, MADV_POPULATE_WRITE) == 0;
+    #endif
+    if (!populated) {
+        /* Older kernels, touch every page */
+        u64 page_size = os_GetPageSize();
+        for (u8 *p = (u8*) memory; p < (u8*) memory + size; p += page_size) {
+            *(volatile u8*) p = *(volatile u8*) p;
+        }
+    }
+}
+
+u64 os_GetLargePageSize() {
+    return MB(2);
+}
+
+void* os_ReserveLarge(upr size) {
+    void *result = 0;
+    #if OS_LINUX
+    /* Explicit huge pages only work if the admin has set aside a pool for them. Without
+       MAP_NORESERVE the mmap fails up front when the pool is too small. */
+    result = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, (off_t) 0);
+    if (result == MAP_FAILED) {
+        result = 0;
+
+        /* Otherwise use transparent huge pages. Over-reserve so the range can be trimmed to
+           a large page boundary, madvise fails if THP is disabled. */
+        u64 large_page = os_GetLargePageSize();
+        u8 *mem = (u8*) mmap(0, size + large_page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, (off_t) 0);
+        if (mem != MAP_FAILED) {
+            u8 *aligned = (u8*)(((upr) mem + large_page-1) & ~(large_page-1));
+            if (aligned > mem) {
+                munmap(mem, aligned - mem);
+            }
+            munmap(aligned + size, (mem + size + large_page) - (aligned + size));
+            
+            if (madvise(aligned, size, MADV_HUGEPAGE) == 0) {
+                result = aligned;
+            } else {
+                munmap(aligned, size);
+            }
+        }
+    }
+    #endif
+    (void) size;
+    return result;
+}
+
 u64 os_GetThreadID(void) {
     #if OS_LINUX
     ASSERTSTATIC(sizeof(pid_t) <= sizeof(u64), threadIdIs64Bits);
@@ -40,3 +317,24 @@ u64 os_GetThreadID(void) {
     return pthread_getthreadid_np(); 
     #endif
 }
+
+internal void* posix_ThreadStart(void *arg) {
+    os_Thread *thread = (os_Thread*) arg;
+    Arena_thread_init_scratch();
+    thread->proc(thread->data);
+    return 0;
+}
+
+s32 os_ThreadStart(os_Thread *thread, os_ThreadProc *proc, void *data) {
+    ASSERTSTATIC(sizeof(pthread_t) <= sizeof(u64), pthreadIs64Bits);
+    thread->proc = proc;
+    thread->data = data;
+    pthread_t handle;
+    s32 result = pthread_create(&handle, 0, posix_ThreadStart, thread) == 0;
+    thread->handle = (u64) handle;
+    return result;
+}
+
+void os_ThreadJoin(os_Thread *thread) {
+    pthread_join((pthread_t) thread->handle, 0);
+}
@@ -9,5 +9,7 @@
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/mman.h>
+#include <pthread.h>
+#include <signal.h>
 
 #endif /* LCF_POSIX */
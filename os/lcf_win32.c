@@ -34,11 +34,37 @@ void os_Decommit(void *memory, upr size) {
     VirtualFree(memory, size, MEM_DECOMMIT);
 }
 
+s32 os_Protect(void *memory, upr size) {
+    DWORD old_protect;
+    return !!VirtualProtect(memory, size, PAGE_NOACCESS, &old_protect);
+}
+
 void os_Free(void *memory, upr size) {
     (void) size;
     VirtualFree(memory, 0, MEM_RELEASE);
 }
 
+void os_Prefault(void *memory, upr size) {
+    /* NOTE(lcf): PrefetchVirtualMemory only helps file backed memory, so touch every page */
+    u64 page_size = os_GetPageSize();
+    for (u8 *p = (u8*) memory; p < (u8*) memory + size; p += page_size) {
+        *(volatile u8*) p = *(volatile u8*) p;
+    }
+}
+
+u64 os_GetLargePageSize() {
+    u64 result = GetLargePageMinimum();
+    return result? result : MB(2);
+}
+
+void* os_ReserveLarge(upr size) {
+    /* NOTE(lcf): Always fails on win32. MEM_LARGE_PAGES has to be committed up front and needs
+       SeLockMemoryPrivilege, which doesn't fit reserve/commit. On 0 Arena_create clears
+       ARENA_LARGE_PAGES and reserves normal pages with os_Reserve instead. */
+    (void) size;
+    return 0;
+}
+
 str os_ReadFile(Arena *arena, str filepath) {
     str fileString = ZERO_STRUCT;
 
@@ -193,10 +219,211 @@ u64 os_GetTimeCycles(void) {
 }
 
 
+void* os_MapFile(char *path, upr size) {
+    void *result = 0;
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, 0, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file != INVALID_HANDLE_VALUE) {
+        /* Mapping more than the file size grows the file */
+        HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READWRITE, (DWORD)((u64) size >> 32), (DWORD)(size & 0xFFFFFFFF), 0);
+        if (mapping) {
+            result = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+            CloseHandle(mapping); /* The view keeps the mapping alive */
+        }
+        CloseHandle(file);
+    }
+    return result;
+}
+
+void os_UnmapFile(char *path, void *memory, upr size, upr file_size) {
+    (void) size;
+    UnmapViewOfFile(memory);
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, 0, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER end;
+        end.QuadPart = (LONGLONG) file_size;
+        SetFilePointerEx(file, end, 0, FILE_BEGIN);
+        SetEndOfFile(file);
+        CloseHandle(file);
+    }
+}
+
+/* NOTE(lcf) There is no way to reserve the whole range and then map into it without
+   VirtualAlloc2, so find a free range, release it, and map both views there. Another thread
+   can take the range in between, so retry a few times. */
+void* os_MapRing(upr size) {
+    void *result = 0;
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, (DWORD)((u64) size >> 32), (DWORD)(size & 0xFFFFFFFF), 0);
+    if (mapping) {
+        for (s32 attempt = 0; attempt < 16 && !result; attempt++) {
+            u8 *base = (u8*) VirtualAlloc(0, 2*size, MEM_RESERVE, PAGE_NOACCESS);
+            if (!base) {
+                break;
+            }
+            VirtualFree(base, 0, MEM_RELEASE);
+            void *lo = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, base);
+            void *hi = lo? MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, base + size) : 0;
+            if (lo && hi) {
+                result = base;
+            } else if (lo) {
+                UnmapViewOfFile(lo);
+            }
+        }
+        CloseHandle(mapping); /* The views keep the mapping alive */
+    }
+    return result;
+}
+
+void os_UnmapRing(void *memory, upr size) {
+    UnmapViewOfFile(memory);
+    UnmapViewOfFile((u8*) memory + size);
+}
+
+/* Write watching, like posix but with a vectored exception handler. Only write faults on a
+   watched range are handled, everything else continues the search. */
+#define WIN32_WATCH_MAX 64
+struct win32_Watch {
+    u64 start;
+    u64 end;
+    u64 page_size;
+    u64 *dirty;
+};
+global struct win32_Watch win32_watches[WIN32_WATCH_MAX];
+global u64 win32_watch_lock;
+global void *win32_watch_handler;
+
+internal LONG CALLBACK win32_WriteFault(PEXCEPTION_POINTERS info) {
+    PEXCEPTION_RECORD record = info->ExceptionRecord;
+    if (record->ExceptionCode == EXCEPTION_ACCESS_VIOLATION && record->ExceptionInformation[0] == 1) {
+        u64 address = (u64) record->ExceptionInformation[1];
+        for (s32 i = 0; i < WIN32_WATCH_MAX; i++) {
+            struct win32_Watch *w = win32_watches + i;
+            u64 start = ATOMIC_LOAD_U64(&w->start);
+            if (start && address >= start && address < ATOMIC_LOAD_U64(&w->end)) {
+                u64 page = (address - start) / w->page_size;
+                u64 *word = w->dirty + (page >> 6);
+                u64 old = ATOMIC_LOAD_U64(word);
+                while (!ATOMIC_CAS_U64(word, old, old | (1ull << (page & 63)))) {
+                    old = ATOMIC_LOAD_U64(word);
+                }
+                DWORD old_protect;
+                VirtualProtect((void*)(start + page * w->page_size), w->page_size, PAGE_READWRITE, &old_protect);
+                return EXCEPTION_CONTINUE_EXECUTION;
+            }
+        }
+    }
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+
+s32 os_WatchWrites(void *memory, upr size, upr page_size, u64 *dirty) {
+    while (!ATOMIC_CAS_U64(&win32_watch_lock, 0, 1)) {
+        CPU_PAUSE();
+    }
+    if (!win32_watch_handler) {
+        win32_watch_handler = AddVectoredExceptionHandler(1, win32_WriteFault);
+    }
+
+    s32 result = 0;
+    struct win32_Watch *free_slot = 0;
+    for (s32 i = 0; i < WIN32_WATCH_MAX && !result; i++) {
+        struct win32_Watch *w = win32_watches + i;
+        if (w->start == (u64) memory) {
+            if (size) {
+                ATOMIC_STORE_U64(&w->end, (u64) memory + size);
+            } else {
+                ATOMIC_STORE_U64(&w->start, 0);
+            }
+            result = 1;
+        } else if (!w->start && !free_slot) {
+            free_slot = w;
+        }
+    }
+    if (!result && size && free_slot && win32_watch_handler) {
+        free_slot->page_size = page_size;
+        free_slot->dirty = dirty;
+        ATOMIC_STORE_U64(&free_slot->end, (u64) memory + size);
+        ATOMIC_STORE_U64(&free_slot->start, (u64) memory);
+        result = 1;
+    }
+
+    ATOMIC_STORE_U64(&win32_watch_lock, 0);
+    return result;
+}
+
+void os_ProtectWrites(void *memory, upr size, s32 writable) {
+    DWORD old_protect;
+    VirtualProtect(memory, size, writable? PAGE_READWRITE : PAGE_READONLY, &old_protect);
+}
+
+u32 os_NumaNodeCount(void) {
+    ULONG highest = 0;
+    return GetNumaHighestNodeNumber(&highest)? (u32) highest + 1 : 1;
+}
+
+/* NOTE(lcf) Always fails on win32. Reserved memory can't be given a node after the fact, that
+   takes VirtualAllocExNuma at reserve time. On 0 Arena_create clears ARENA_NUMA. Windows already
+   places pages on the node of the thread that first touches them, which is the thread itself
+   for scratch arenas. */
+s32 os_NumaBind(void *memory, upr size, u32 node) {
+    (void) memory;
+    (void) size;
+    (void) node;
+    return 0;
+}
+
+s32 os_NumaCurrentNode(void) {
+    s32 result = -1;
+    PROCESSOR_NUMBER processor;
+    USHORT node;
+    if (os_NumaNodeCount() > 1) {
+        GetCurrentProcessorNumberEx(&processor);
+        if (GetNumaProcessorNodeEx(&processor, &node)) {
+            result = (s32) node;
+        }
+    }
+    return result;
+}
+
+s32 os_NumaPageNodes(void **pages, u64 count, s32 *nodes) {
+    PSAPI_WORKING_SET_EX_INFORMATION info[64];
+    for (u64 i = 0; i < count; i += ARRAY_LENGTH(info)) {
+        u64 n = MIN(count - i, ARRAY_LENGTH(info));
+        for (u64 j = 0; j < n; j++) {
+            info[j].VirtualAddress = pages[i+j];
+        }
+        if (!QueryWorkingSetEx(GetCurrentProcess(), info, (DWORD)(n * sizeof(info[0])))) {
+            return 0;
+        }
+        for (u64 j = 0; j < n; j++) {
+            nodes[i+j] = info[j].VirtualAttributes.Valid? (s32) info[j].VirtualAttributes.Node : -1;
+        }
+    }
+    return 1;
+}
+
 u64 os_GetThreadID(void) {
     return GetThreadId(0);
 }
 
+internal DWORD WINAPI win32_ThreadStart(LPVOID arg) {
+    os_Thread *thread = (os_Thread*) arg;
+    Arena_thread_init_scratch();
+    thread->proc(thread->data);
+    return 0;
+}
+
+s32 os_ThreadStart(os_Thread *thread, os_ThreadProc *proc, void *data) {
+    thread->proc = proc;
+    thread->data = data;
+    HANDLE handle = CreateThread(0, 0, win32_ThreadStart, thread, 0, 0);
+    thread->handle = (u64) handle;
+    return handle != 0;
+}
+
+void os_ThreadJoin(os_Thread *thread) {
+    WaitForSingleObject((HANDLE) thread->handle, INFINITE);
+    CloseHandle((HANDLE) thread->handle);
+}
+
 
 internal void win32_ReadBlock(HANDLE file, void* block, u64 block_size) {
     char *ptr = (char*) block;
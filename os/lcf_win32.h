@@ -9,6 +9,7 @@
 #define NO
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <psapi.h>
 
 /* Helper macros */
 #undef ASSERT
@@ -144,7 +144,7 @@ typedef struct Scene {
 
 struct _Assets {
     // Chunking for scenes
-    SceneObjChunk *free_obj_chunk;
+    Pool *obj_chunk_pool;
 
     // NOTE(lcf): 0 is a null obj/scene/whatever
     Asset obj_handle[MAX_ASSET_OBJ]; 
@@ -219,18 +219,19 @@ Asset* SceneAsset(Scene *s) {
     return G->assets.scene_handle + (s32)(s - G->assets.scene);
 }
 
-SceneObjChunk* AllocObjChunk(Arena *a) {
-    SceneObjChunk* out = G->assets.free_obj_chunk;
-    if (out) {
-        G->assets.free_obj_chunk = out->next;
-        out->next = 0;
-    } else {
-        out = Arena_take_zero(a, sizeof(SceneObjChunk));
+SceneObjChunk* AllocObjChunk(Pool *chunks) {
+    return Pool_take_struct_zero(chunks, SceneObjChunk);
+}
+
+void FreeObjChunks(Pool *chunks, SceneObjChunk *c) {
+    while (c) {
+        SceneObjChunk *next = c->next;
+        Pool_free(chunks, c);
+        c = next;
     }
-    return out;
 }
 
-s32 CopyWorldToScene(Arena *a, Scene *scene) {
+s32 CopyWorldToScene(Pool *chunks, Scene *scene) {
     scene->objs = 0;
     scene->obj_bounds = (Rect){0, 0, 32, 32};
 
@@ -244,7 +245,7 @@ s32 CopyWorldToScene(Arena *a, Scene *scene) {
         if (o->scene_depth == 0) {
             if (c->objs == SCENE_OBJ_CHUNK_SIZE) {
                 if (!c->next) {
-                    c->next = AllocObjChunk(a);
+                    c->next = AllocObjChunk(chunks);
                 }
                 c = c->next; c->objs = 0;
                 scene->objs += SCENE_OBJ_CHUNK_SIZE;
@@ -258,15 +259,8 @@ s32 CopyWorldToScene(Arena *a, Scene *scene) {
     }
 
     if (c->next) { // place now unused chunks on free list
-        SceneObjChunk *first = c->next;
-        SceneObjChunk *last = first; 
-        while (last->next) {
-            last = last->next;
-        }
-        if (last) {
-            last->next = G->assets.free_obj_chunk;
-            G->assets.free_obj_chunk = first;
-        }
+        FreeObjChunks(chunks, c->next);
+        c->next = 0;
     }
 
     scene->objs += c->objs;
@@ -491,14 +485,13 @@ typedef struct Serdes {
 } Serdes;
 
 Serdes* des_start(Arena *perm, Arena *temp, str input) {
-    u64 temp_start = temp->pos;
+    u64 temp_start = Arena_pos(temp);
     Serdes *serdes = Arena_take(temp, sizeof(Serdes));
     (*serdes) = (Serdes) {
         .temp = temp,
         .temp_start = temp_start,
         .perm = perm,
         .json = (json) {
-            .arena = temp,
             .input = input
         },
     };
@@ -507,11 +500,12 @@ Serdes* des_start(Arena *perm, Arena *temp, str input) {
 }
 
 void des_end(Serdes *serdes) {
+    json_free(&serdes->json);
     Arena_reset(serdes->temp, serdes->temp_start);
 }
 
 Serdes* ser_start(Arena *temp) {
-    u64 temp_start = temp->pos;
+    u64 temp_start = Arena_pos(temp);
     Serdes* serdes = Arena_take(temp, sizeof(Serdes));
     *serdes = (Serdes){
         .temp = temp,
@@ -615,7 +609,8 @@ static s32 serdes_u32(Serdes *serdes, str key, u32 *v, u32 def) {
 static s32 serdes_f32(Serdes *serdes, str key, f32 *v, f32 def) {
     if (serdes->is_writing) {
         if (*v != def) {
-            serdes_print(serdes, strf(serdes->temp, "%.*s: %g,\n", key.len, key.str, *v));
+            str f = str_from_f32(serdes->temp, *v);
+            serdes_print(serdes, strf(serdes->temp, "%.*s: %.*s,\n", key.len, key.str, str_PRINTF_ARGS(f)));
         }
     } else {
         json_token *t = json_find_key(&serdes->json, serdes->parent, key);
@@ -642,7 +637,8 @@ static s32 serdes_color(Serdes *serdes, str key, Color *v, Color def) {
 static s32 serdes_Vec2(Serdes *serdes, str key, Vec2 *v, Vec2 def) {
     if (serdes->is_writing) {
         if (memcmp(v, &def, sizeof(*v))) {
-            serdes_print(serdes, strf(serdes->temp, "%.*s: [%g, %g],\n", key.len, key.str, v->x, v->y));
+            str x = str_from_f32(serdes->temp, v->x), y = str_from_f32(serdes->temp, v->y);
+            serdes_print(serdes, strf(serdes->temp, "%.*s: [%.*s, %.*s],\n", key.len, key.str, str_PRINTF_ARGS(x), str_PRINTF_ARGS(y)));
         }
     } else {
         json_token *t = json_find_key(&serdes->json, serdes->parent, key);
@@ -658,7 +654,8 @@ static s32 serdes_Vec2(Serdes *serdes, str key, Vec2 *v, Vec2 def) {
 static s32 serdes_Vec3(Serdes *serdes, str key, Vec3 *v, Vec3 def) {
     if (serdes->is_writing) {
         if (memcmp(v, &def, sizeof(*v))) {
-            serdes_print(serdes, strf(serdes->temp, "%.*s: [%g, %g, %g],\n", key.len, key.str, v->x, v->y, v->z));
+            str x = str_from_f32(serdes->temp, v->x), y = str_from_f32(serdes->temp, v->y), z = str_from_f32(serdes->temp, v->z);
+            serdes_print(serdes, strf(serdes->temp, "%.*s: [%.*s, %.*s, %.*s],\n", key.len, key.str, str_PRINTF_ARGS(x), str_PRINTF_ARGS(y), str_PRINTF_ARGS(z)));
         }
     } else {
         json_token *t = json_find_key(&serdes->json, serdes->parent, key);
@@ -675,7 +672,8 @@ static s32 serdes_Vec3(Serdes *serdes, str key, Vec3 *v, Vec3 def) {
 static s32 serdes_Vec4(Serdes *serdes, str key, Vec4 *v, Vec4 def) {
     if (serdes->is_writing) {
         if (memcmp(v, &def, sizeof(*v))) {
-            serdes_print(serdes, strf(serdes->temp, "%.*s: [%g, %g, %g, %g],\n", key.len, key.str, v->x, v->y, v->z, v->w));
+            str x = str_from_f32(serdes->temp, v->x), y = str_from_f32(serdes->temp, v->y), z = str_from_f32(serdes->temp, v->z), w = str_from_f32(serdes->temp, v->w);
+            serdes_print(serdes, strf(serdes->temp, "%.*s: [%.*s, %.*s, %.*s, %.*s],\n", key.len, key.str, str_PRINTF_ARGS(x), str_PRINTF_ARGS(y), str_PRINTF_ARGS(z), str_PRINTF_ARGS(w)));
         }
     } else {
         json_token *t = json_find_key(&serdes->json, serdes->parent, key);
@@ -693,7 +691,8 @@ static s32 serdes_Vec4(Serdes *serdes, str key, Vec4 *v, Vec4 def) {
 static s32 serdes_Rect(Serdes *serdes, str key, Rect *v, Rect def) {
     if (serdes->is_writing) {
         if (memcmp(v, &def, sizeof(*v))) {
-            serdes_print(serdes, strf(serdes->temp, "%.*s: [%g, %g, %g, %g],\n", key.len, key.str, v->x, v->y, v->w, v->h));
+            str x = str_from_f32(serdes->temp, v->x), y = str_from_f32(serdes->temp, v->y), w = str_from_f32(serdes->temp, v->w), h = str_from_f32(serdes->temp, v->h);
+            serdes_print(serdes, strf(serdes->temp, "%.*s: [%.*s, %.*s, %.*s, %.*s],\n", key.len, key.str, str_PRINTF_ARGS(x), str_PRINTF_ARGS(y), str_PRINTF_ARGS(w), str_PRINTF_ARGS(h)));
         }
     } else {
         json_token *t = json_find_key(&serdes->json, serdes->parent, key);
@@ -756,7 +755,7 @@ s32 serdes_scene(Serdes *serdes, Scene *s) {
         for (json_iter(&serdes->json, objs, obj)) {
             if (c->objs == SCENE_OBJ_CHUNK_SIZE) {
                 if (!c->next) {
-                    c->next = AllocObjChunk(serdes->perm);
+                    c->next = AllocObjChunk(G->assets.obj_chunk_pool);
                 }
                 if (c->next) {
                     s->objs += SCENE_OBJ_CHUNK_SIZE;
@@ -787,28 +786,33 @@ int main() {
 
     Arena *a = Arena_create();
     G = Arena_take(a, sizeof(*G));
+    G->assets.obj_chunk_pool = Pool_default(a, SceneObjChunk);
+    Frames frames = Frames_create(2);
+    Arena *frame = Frame_begin(&frames);
 
-    str scene_json = os_ReadFile(a, strl("test.dd"));
+    str scene_json = os_ReadFile(frame, strl("test.dd"));
     Scene *s = G->assets.scene + 1;
     {
-        Serdes *des = des_start(a, Arena_scratch(), scene_json);
+        Serdes *des = des_start(a, frame, scene_json);
         serdes_scene(des, s);
         des_end(des);
     }
    
     {
-        Serdes *ser = ser_start(Arena_scratch());
+        Serdes *ser = ser_start(frame);
         serdes_scene(ser, s);
         ser_end(ser, strl("test_ser.dd"));
     }
     
   //   while (!WindowShouldClose()) {
+  //       frame = Frame_begin(&frames);
   //       BeginDrawing();
 		// ClearBackground(WHITE);
 		
   //       /* Draw Here */
 
   //       DrawFPS(16, 16);
+  //       DrawText(TextFormat("frame memory: %d KB", (s32)(frames.last_peak/1024)), 16, 40, 20, DARKGRAY);
   //       EndDrawing();
   //   }
 	
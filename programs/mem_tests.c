@@ -0,0 +1,573 @@
+#include "lcf/lcf.h"
+#include "lcf/lcf.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Behaviour checks for the allocators, each section prints how many checks failed */
+static unsigned long long checks, failures; /* Not u64, so %llu works everywhere */
+#define CHECK(cond) do {                                                \
+        checks++;                                                       \
+        if (!(cond) && failures++ < 10) {                               \
+            printf("FAILED line %d: %s\n", __LINE__, #cond);            \
+        }                                                               \
+    } while (0)
+
+static void fill(void *p, u64 size, u8 seed) {
+    for (u64 i = 0; i < size; i++) {
+        ((u8*) p)[i] = (u8) (seed + i*7);
+    }
+}
+
+static s32 filled(void *p, u64 size, u8 seed) {
+    for (u64 i = 0; i < size; i++) {
+        if (((u8*) p)[i] != (u8) (seed + i*7)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Chained arenas: takes link in new blocks, resets and sessions pop back across them and
+   reuse the released blocks */
+#define CHAIN_TAKES 40
+static void check_chained(void) {
+    checks = failures = 0;
+    Arena *a = Arena_create(.size = KB(64), .flags = ARENA_CHAINED);
+    u8 *ptr[CHAIN_TAKES];
+    u64 pos[CHAIN_TAKES];
+    u64 size = KB(10);
+    for (s32 i = 0; i < CHAIN_TAKES; i++) {
+        pos[i] = Arena_pos(a);
+        ptr[i] = Arena_take(a, size);
+        fill(ptr[i], size, (u8) i);
+        CHECK(Arena_pos(a) >= pos[i] + size);
+    }
+    CHECK(a->current != a);
+    for (s32 i = 0; i < CHAIN_TAKES; i++) {
+        CHECK(filled(ptr[i], size, (u8) i));
+    }
+
+    /* Back into the middle of the chain, taking the same again lands in the cached blocks */
+    s32 mid = CHAIN_TAKES/2;
+    Arena *last = a->current;
+    Arena_reset(a, pos[mid]);
+    CHECK(Arena_pos(a) == pos[mid]);
+    CHECK(a->current != last && a->free != 0);
+    for (s32 i = 0; i < mid; i++) {
+        CHECK(filled(ptr[i], size, (u8) i));
+    }
+    for (s32 i = mid; i < CHAIN_TAKES; i++) {
+        CHECK(Arena_take(a, size) == ptr[i]);
+    }
+    CHECK(a->current == last && a->free == 0);
+
+    /* A session across blocks, and one take bigger than a whole block */
+    ArenaSession session = ArenaSession_begin(a);
+    u8 *big = Arena_take(a, KB(200));
+    fill(big, KB(200), 1);
+    CHECK(filled(big, KB(200), 1));
+    for (s32 i = 0; i < CHAIN_TAKES; i++) {
+        Arena_take(a, size);
+    }
+    ArenaSession_end(session);
+    CHECK(Arena_pos(a) == session.save_point && a->current == last);
+
+    /* resetp finds the block an allocation came from */
+    Arena_resetp(a, ptr[1]);
+    CHECK(Arena_pos(a) == pos[1] && a->current == a);
+    CHECK(filled(ptr[0], size, 0));
+    Arena_destroy(a);
+    printf("chained arenas: %llu checks, %llu failures\n", checks, failures);
+}
+
+/* Pools: freed slots are reused before carving more, and PoolCaches on several threads never
+   hand the same slot to two owners and give everything back at the end */
+#define POOL_THREADS 4
+#define POOL_LIVE 200
+#define POOL_OPS 50000
+typedef struct PoolWorker {
+    os_Thread thread;
+    Pool *pool;
+    u32 id;
+    u64 *live[POOL_LIVE];
+    u32 bad;
+} PoolWorker;
+
+static OS_THREAD_PROC(pool_worker) {
+    PoolWorker *w = (PoolWorker*) data;
+    PoolCache cache = PoolCache_begin(w->pool);
+    RNG rng = {{ 0x9E3779B97F4A7C15ull + w->id, 0x2545F4914F6CDD1Dull }};
+    for (s32 i = 0; i < POOL_LIVE; i++) {
+        w->live[i] = PoolCache_take(&cache);
+        w->live[i][0] = w->id;
+        w->live[i][1] = i;
+    }
+    for (s32 i = 0; i < POOL_OPS; i++) {
+        u32 k = randu32(&rng) % POOL_LIVE;
+        u64 *slot = w->live[k];
+        w->bad += (slot[0] != w->id || slot[1] != k);
+        PoolCache_free(&cache, slot);
+        slot = PoolCache_take(&cache);
+        slot[0] = w->id;
+        slot[1] = k;
+        w->live[k] = slot;
+    }
+    for (s32 i = 0; i < POOL_LIVE; i++) {
+        w->bad += (w->live[i][0] != w->id || w->live[i][1] != (u64) i);
+        PoolCache_free(&cache, w->live[i]);
+    }
+    PoolCache_end(&cache);
+}
+
+static void check_pools(void) {
+    checks = failures = 0;
+    Arena *a = Arena_create();
+    Pool *p = Pool_create(a, 24, 16);
+    CHECK(p->slot_size == 32);
+    u64 start = Arena_pos(a);
+    u8 *slot[64];
+    for (s32 i = 0; i < ARRAY_LENGTH(slot); i++) {
+        slot[i] = Pool_take(p);
+        fill(slot[i], 24, (u8) i);
+        CHECK(((upr) slot[i] & 15) == 0);
+    }
+    for (s32 i = 0; i < ARRAY_LENGTH(slot); i++) {
+        CHECK(filled(slot[i], 24, (u8) i));
+    }
+    for (s32 i = 0; i < ARRAY_LENGTH(slot); i += 2) {
+        Pool_free(p, slot[i]);
+    }
+    u64 pos = Arena_pos(a);
+    for (s32 i = ARRAY_LENGTH(slot) - 2; i >= 0; i -= 2) {
+        u8 *s = Pool_take_zero(p);
+        CHECK(s == slot[i]); /* Last freed comes back first */
+        CHECK(s[0] == 0 && s[23] == 0);
+    }
+    CHECK(Arena_pos(a) == pos && p->slots == ARRAY_LENGTH(slot));
+    Pool_reset(p);
+    CHECK(Arena_pos(a) == start && p->slots == 0 && p->free == 0);
+
+    PoolWorker *workers = Arena_take_array_zero(a, PoolWorker, POOL_THREADS);
+    for (u32 t = 0; t < POOL_THREADS; t++) {
+        workers[t].pool = p;
+        workers[t].id = t + 1;
+        os_ThreadStart(&workers[t].thread, pool_worker, workers + t);
+    }
+    for (u32 t = 0; t < POOL_THREADS; t++) {
+        os_ThreadJoin(&workers[t].thread);
+        CHECK(workers[t].bad == 0);
+    }
+    u64 free_slots = 0;
+    for (PoolSlot *s = p->free; s; s = s->next) {
+        free_slots++;
+    }
+    CHECK(free_slots == p->slots && p->lock == 0);
+    Arena_destroy(a);
+    printf("pools: %llu checks, %llu failures\n", checks, failures);
+}
+
+/* VArrays: grow in place with doubling commits, pushes come back zeroed, and a full array
+   returns 0 without changing */
+static void check_varrays(void) {
+    checks = failures = 0;
+    VArray v = VArray_create(u64, 1 << 20);
+    u8 *data = v.data;
+    u64 grows = 0, commit_pos = 0;
+    for (u64 i = 0; i < 200000; i++) {
+        u64 *e = VArray_push_struct(&v, u64);
+        CHECK(e && *e == 0);
+        *e = i;
+        if (v.commit_pos != commit_pos) {
+            grows++;
+            commit_pos = v.commit_pos;
+        }
+    }
+    CHECK(v.data == data && v.len == 200000);
+    CHECK(v.commit_pos >= v.len*sizeof(u64) && v.commit_pos <= v.size);
+    CHECK(grows < 20); /* 1.6MB in doubling steps from 4KB */
+    s32 same = true;
+    for (u64 i = 0; i < v.len; i++) {
+        same &= (*VArray_get(&v, u64, i) == i);
+    }
+    CHECK(same);
+
+    u64 more[1000];
+    for (s32 i = 0; i < ARRAY_LENGTH(more); i++) {
+        more[i] = ~(u64) i;
+    }
+    CHECK(VArray_append(&v, more, ARRAY_LENGTH(more)) == (void*) VArray_get(&v, u64, 200000));
+    CHECK(*VArray_get(&v, u64, 200999) == ~(u64) 999);
+    CHECK(*(u64*) VArray_pop(&v) == ~(u64) 999 && v.len == 200999);
+    CHECK(*VArray_push_struct(&v, u64) == 0);
+    commit_pos = v.commit_pos;
+    VArray_reset(&v, 10);
+    CHECK(v.len == 10 && v.commit_pos == commit_pos && *VArray_get(&v, u64, 9) == 9);
+    VArray_destroy(&v);
+
+    /* max_count rounds up to whole pages, 1000 u32s give 1024 */
+    VArray full = VArray_create(u32, 1000);
+    u64 pushed = 0;
+    while (VArray_push(&full)) {
+        pushed++;
+    }
+    CHECK(pushed == full.size/sizeof(u32) && full.len == pushed);
+    CHECK(VArray_append(&full, more, 1) == 0 && full.len == pushed);
+    VArray_reset(&full, 0);
+    CHECK(VArray_append(&full, more, pushed + 1) == 0 && full.len == 0);
+    CHECK(VArray_append(&full, more, 2) == full.data && full.len == 2);
+    VArray_destroy(&full);
+    printf("varrays: %llu checks, %llu failures\n", checks, failures);
+}
+
+/* TLSF Heap: frees merge with free neighbours, allocs split free blocks, realloc grows in place
+   into a free neighbour and moves otherwise. Then a random mix of alloc/free/realloc checks no
+   two blocks overlap and everything merges back into one free block. */
+#define HEAP_LIVE 1000
+#define HEAP_OPS 100000
+static s32 heap_is_empty(Heap *h) {
+    HeapStats s = Heap_stats(h);
+    return s.used_blocks == 0 && s.free_blocks == 1 && s.largest_free == s.free_bytes;
+}
+
+static void check_heap(void) {
+    checks = failures = 0;
+    Heap *h = Heap_create();
+
+    u8 *x = Heap_alloc(h, 100), *y = Heap_alloc(h, 200), *z = Heap_alloc(h, 300);
+    CHECK(Heap_block_size(x) >= 100 && Heap_block_size(y) >= 200 && Heap_block_size(z) >= 300);
+    CHECK(y > x + 100 && z > y + 200);
+    HeapStats s = Heap_stats(h);
+    CHECK(s.used_blocks == 3 && s.free_blocks == 1);
+    Heap_free(h, y);
+    s = Heap_stats(h);
+    CHECK(s.used_blocks == 2 && s.free_blocks == 2 && s.fragmentation > 0);
+    u8 *w = Heap_alloc(h, 150);
+    CHECK(w == y); /* Split from the hole y left, not the tail */
+    s = Heap_stats(h);
+    CHECK(s.used_blocks == 3 && s.free_blocks == 2);
+    Heap_free(h, x);
+    Heap_free(h, z);
+    Heap_free(h, w);
+    CHECK(heap_is_empty(h));
+
+    /* realloc: in place into the free tail, shrinking in place, moving when the next block is used */
+    u8 *p = Heap_alloc(h, 64);
+    fill(p, 64, 3);
+    CHECK(Heap_realloc(h, p, 4000) == p && Heap_block_size(p) >= 4000 && filled(p, 64, 3));
+    CHECK(Heap_realloc(h, p, 32) == p && filled(p, 32, 3));
+    CHECK(Heap_stats(h).free_blocks == 1);
+    u8 *q = Heap_alloc(h, 64);
+    u8 *moved = Heap_realloc(h, p, 4000);
+    CHECK(moved != p && filled(moved, 32, 3));
+    s = Heap_stats(h);
+    CHECK(s.used_blocks == 2 && s.free_blocks == 2);
+    Heap_free(h, q);
+    Heap_free(h, moved);
+    CHECK(heap_is_empty(h));
+
+    u8 *aligned = Heap_alloc_custom(h, 100, 256);
+    u8 *zero = Heap_alloc_zero(h, 300);
+    CHECK(((upr) aligned & 255) == 0 && zero[0] == 0 && zero[299] == 0);
+    Heap_free(h, aligned);
+    Heap_free(h, zero);
+    CHECK(heap_is_empty(h));
+
+    RNG rng = {{ 0x243F6A8885A308D3ull, 0x13198A2E03707344ull }};
+    u8 *live[HEAP_LIVE] = {0};
+    u64 size[HEAP_LIVE] = {0};
+    s32 intact = true;
+    for (s32 i = 0; i < HEAP_OPS; i++) {
+        u32 k = randu32(&rng) % HEAP_LIVE;
+        u64 new_size = 1 + randu32(&rng) % ((randu32(&rng) % 16 == 0)? KB(64) : 512);
+        if (live[k]) {
+            intact &= filled(live[k], size[k], (u8) k);
+        }
+        switch (randu32(&rng) % 3) {
+            case 0: {
+                Heap_free(h, live[k]);
+                live[k] = Heap_alloc(h, new_size);
+            } break;
+            case 1: {
+                live[k] = Heap_realloc(h, live[k], new_size);
+                if (live[k]) {
+                    intact &= filled(live[k], MIN(size[k], new_size), (u8) k);
+                }
+            } break;
+            case 2: {
+                Heap_free(h, live[k]);
+                live[k] = 0;
+                new_size = 0;
+            } break;
+        }
+        size[k] = live[k]? new_size : 0;
+        fill(live[k], size[k], (u8) k);
+    }
+    CHECK(intact);
+    for (s32 k = 0; k < HEAP_LIVE; k++) {
+        Heap_free(h, live[k]);
+    }
+    CHECK(heap_is_empty(h));
+    Heap_destroy(h);
+    printf("heap: %llu checks, %llu failures\n", checks, failures);
+}
+
+/* AtomicStack and AtomicQueue under threads. Stack threads pop nodes and push them back, each
+   node flags itself while popped so a node handed to two threads at once (ABA) shows up. Queue
+   producers push numbered nodes and the one consumer checks each producer's come out in order. */
+#define ATOMIC_THREADS 4
+#define ATOMIC_NODES 64
+#define ATOMIC_OPS 100000
+typedef struct TestNode {
+    struct TestNode *next;
+    u64 owner;
+    u64 seq;
+    u64 popped;
+} TestNode;
+
+typedef struct AtomicWorker {
+    os_Thread thread;
+    AtomicStack *stack;
+    AtomicQueue *queue;
+    TestNode *nodes;
+    u32 id;
+    u32 bad;
+} AtomicWorker;
+
+static OS_THREAD_PROC(stack_worker) {
+    AtomicWorker *w = (AtomicWorker*) data;
+    for (s32 i = 0; i < ATOMIC_OPS; i++) {
+        TestNode *n = PopSAtomic(w->stack, TestNode);
+        if (n) {
+            w->bad += (ATOMIC_EXCHANGE_U64(&n->popped, 1) != 0);
+            n->owner = w->id;
+            ATOMIC_STORE_U64(&n->popped, 0);
+            PushSAtomic(w->stack, n);
+        }
+    }
+}
+
+static OS_THREAD_PROC(queue_worker) {
+    AtomicWorker *w = (AtomicWorker*) data;
+    for (s32 i = 0; i < ATOMIC_OPS; i++) {
+        TestNode *n = w->nodes + i;
+        n->owner = w->id;
+        n->seq = i;
+        PushQAtomic(w->queue, n);
+    }
+}
+
+static void check_atomics(void) {
+    checks = failures = 0;
+    Arena *a = Arena_create();
+    AtomicWorker *workers = Arena_take_array_zero(a, AtomicWorker, ATOMIC_THREADS);
+
+    AtomicStack stack = ZERO_STRUCT;
+    TestNode *nodes = Arena_take_array_zero(a, TestNode, ATOMIC_NODES);
+    for (s32 i = 0; i < ATOMIC_NODES; i++) {
+        nodes[i].seq = i;
+        PushSAtomic(&stack, nodes + i);
+    }
+    for (u32 t = 0; t < ATOMIC_THREADS; t++) {
+        workers[t].stack = &stack;
+        workers[t].id = t + 1;
+        os_ThreadStart(&workers[t].thread, stack_worker, workers + t);
+    }
+    for (u32 t = 0; t < ATOMIC_THREADS; t++) {
+        os_ThreadJoin(&workers[t].thread);
+        CHECK(workers[t].bad == 0);
+    }
+    u64 seen[ATOMIC_NODES] = {0}, count = 0;
+    for (TestNode *n; (n = PopSAtomic(&stack, TestNode)); count++) {
+        CHECK(n >= nodes && n < nodes + ATOMIC_NODES && seen[n->seq]++ == 0);
+    }
+    CHECK(count == ATOMIC_NODES);
+
+    AtomicQueue queue = ZERO_STRUCT;
+    CHECK(PopQAtomic(&queue, TestNode) == 0);
+    for (u32 t = 0; t < ATOMIC_THREADS; t++) {
+        workers[t].queue = &queue;
+        workers[t].nodes = Arena_take_array_zero(a, TestNode, ATOMIC_OPS);
+        os_ThreadStart(&workers[t].thread, queue_worker, workers + t);
+    }
+    u64 next_seq[ATOMIC_THREADS] = {0};
+    s32 in_order = true;
+    for (u64 received = 0; received < ATOMIC_THREADS*ATOMIC_OPS; ) {
+        TestNode *n = PopQAtomic(&queue, TestNode);
+        if (n) {
+            in_order &= (n->owner >= 1 && n->owner <= ATOMIC_THREADS && n->seq == next_seq[n->owner - 1]++);
+            received++;
+        }
+    }
+    CHECK(in_order);
+    for (u32 t = 0; t < ATOMIC_THREADS; t++) {
+        os_ThreadJoin(&workers[t].thread);
+        CHECK(next_seq[t] == ATOMIC_OPS);
+    }
+    CHECK(PopQAtomic(&queue, TestNode) == 0);
+    Arena_destroy(a);
+    printf("atomics: %llu checks, %llu failures\n", checks, failures);
+}
+
+/* Ring: data written across the end of the buffer reads back as one contiguous str, and both
+   mappings show the same bytes. Then a producer thread streams through it in odd sized chunks. */
+#define RING_STREAM MB(8)
+static OS_THREAD_PROC(ring_producer) {
+    Ring *r = (Ring*) data;
+    RNG rng = {{ 0xA4093822299F31D0ull, 0x082EFA98EC4E6C89ull }};
+    for (u64 sent = 0; sent < RING_STREAM; ) {
+        str space = Ring_write_space(r);
+        s64 chunk = 1 + randu32(&rng) % 5000;
+        s64 len = MIN(MIN(space.len, (s64) (RING_STREAM - sent)), chunk);
+        for (s64 i = 0; i < len; i++) {
+            space.str[i] = (char) ((sent + i) % 251);
+        }
+        Ring_commit(r, len);
+        sent += len;
+    }
+}
+
+static void check_ring(void) {
+    checks = failures = 0;
+    Ring r = Ring_create(1000);
+    CHECK(r.data && r.size == KB(64));
+    if (!r.data) {
+        printf("ring: no map_ring, skipped\n");
+        return;
+    }
+    char chunk[KB(20)];
+    fill(chunk, sizeof(chunk), 9);
+    Ring_commit(&r, KB(60) - 100);
+    Ring_consume(&r, KB(60) - 100);
+    CHECK(Ring_read_view(&r).len == 0 && Ring_write_space(&r).len == r.size);
+
+    /* Starts 100 bytes before the end and wraps */
+    CHECK(Ring_write(&r, str_from(chunk, sizeof(chunk))) == sizeof(chunk));
+    str view = Ring_read_view(&r);
+    CHECK(view.len == sizeof(chunk) && view.str == r.data + r.size - KB(4) - 100);
+    CHECK(filled(view.str, view.len, 9));
+    CHECK(memcmp(r.data, r.data + r.size, r.size) == 0);
+    CHECK(filled(r.data, KB(20) - KB(4) - 100, (u8) (9 + (KB(4) + 100)*7)));
+
+    /* Only what fits is written */
+    CHECK(Ring_write(&r, str_from(chunk, sizeof(chunk))) == sizeof(chunk));
+    CHECK(Ring_write(&r, str_from(chunk, sizeof(chunk))) == sizeof(chunk));
+    CHECK(Ring_write(&r, str_from(chunk, sizeof(chunk))) == r.size - 3*sizeof(chunk));
+    CHECK(Ring_write_space(&r).len == 0 && Ring_read_view(&r).len == r.size);
+    Ring_consume(&r, r.size);
+
+    os_Thread producer;
+    os_ThreadStart(&producer, ring_producer, &r);
+    s32 in_order = true;
+    for (u64 received = 0; received < RING_STREAM; ) {
+        str s = Ring_read_view(&r);
+        for (s64 i = 0; i < s.len; i++) {
+            in_order &= (s.str[i] == (char) ((received + i) % 251));
+        }
+        Ring_consume(&r, s.len);
+        received += s.len;
+    }
+    os_ThreadJoin(&producer);
+    CHECK(in_order);
+    Ring_destroy(&r);
+    printf("ring: %llu checks, %llu failures\n", checks, failures);
+}
+
+/* Snapshots: restore brings back pos and contents, and with write tracking only the pages
+   written since the snapshot are copied, including after a reset below the snapshot */
+static void check_snapshots(void) {
+    checks = failures = 0;
+    Arena *a = Arena_create();
+    u64 size = MB(1);
+    u8 *data = Arena_take(a, size);
+    fill(data, size, 5);
+    u64 pos = Arena_pos(a);
+    ArenaSnapshot *s = Arena_snapshot(a);
+    CHECK(s && s->copied >= size/a->commit_size);
+    if (!s) {
+        printf("snapshots: no shadow copy, skipped\n");
+        return;
+    }
+
+    /* Three pages written, plus new memory past the snapshot */
+    data[10] = 0;
+    data[size/2] = 0;
+    data[size - 1] = 0;
+    u8 *more = Arena_take(a, KB(100));
+    fill(more, KB(100), 6);
+    Arena_restore(a);
+    CHECK(Arena_pos(a) == pos && filled(data, size, 5));
+    if (s->watching) {
+        CHECK(s->copied <= 5); /* The three pages and the header */
+    } else {
+        printf("snapshots: no write tracking, every page is copied\n");
+    }
+
+    /* Taking a new snapshot only copies what changed since the last one */
+    data[size/4] = 0;
+    Arena_snapshot(a);
+    CHECK(!s->watching || s->copied <= 3);
+    CHECK(data[size/4] == 0);
+    data[size/4] = (u8) (5 + (size/4)*7);
+
+    /* A reset below the snapshot loses those pages, restore still brings them back */
+    Arena_reset(a, size/2);
+    Arena_take(a, KB(10));
+    Arena_restore(a);
+    CHECK(Arena_pos(a) == pos && filled(data, size/4, 5) && data[size/4] == 0);
+    data[size/4] = (u8) (5 + (size/4)*7);
+    CHECK(filled(data, size, 5));
+
+    /* Once ended the arena is plain memory again */
+    Arena_snapshot_end(a);
+    CHECK(a->snapshot == 0);
+    fill(data, size, 7);
+    CHECK(filled(data, size, 7));
+    Arena_destroy(a);
+    printf("snapshots: %llu checks, %llu failures\n", checks, failures);
+}
+
+/* Frames: each frame's peak counts memory a session or shrink gave back, and the previous
+   frame's memory stays valid until its arena comes round again */
+static void check_frames(void) {
+    checks = failures = 0;
+    Frames f = Frames_create(2);
+    Arena *a = Frame_arena(&f, 0);
+    Arena_take(a, 1000); /* Before the first Frame_begin is frame 0 */
+
+    a = Frame_begin(&f);
+    CHECK(f.last_peak == 1000 && a == Frame_arena(&f, 0) && a != Frame_arena(&f, 1));
+    u8 *kept = Arena_take(a, 5000);
+    fill(kept, 5000, 4);
+    ArenaSession session = ArenaSession_begin(a);
+    Arena_take(a, 20000);
+    ArenaSession_end(session);
+    CHECK(Arena_pos(a) == 5000 && Arena_peak(a) == 25000);
+
+    a = Frame_begin(&f);
+    CHECK(f.last_peak == 25000 && f.max_peak == 25000 && Arena_pos(a) == 0);
+    CHECK(filled(kept, 5000, 4) && Arena_pos(Frame_arena(&f, 1)) == 5000);
+    u8 *shrunk = Arena_take(a, 4000);
+    Arena_shrink(a, shrunk, 4000, 100);
+    CHECK(Arena_pos(a) == 100);
+
+    a = Frame_begin(&f);
+    CHECK(f.last_peak == 4000 && f.max_peak == 25000 && Arena_pos(a) == 0 && Arena_peak(a) == 0);
+    CHECK(f.peak[0] == 4000 && f.peak[1] == 25000 && f.frame == 3);
+    Frames_destroy(&f);
+    printf("frames: %llu checks, %llu failures\n", checks, failures);
+}
+
+int main(void) {
+    os_PlatformInit();
+    check_chained();
+    check_pools();
+    check_varrays();
+    check_heap();
+    check_atomics();
+    check_ring();
+    check_snapshots();
+    check_frames();
+    return 0;
+}
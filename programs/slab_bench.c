@@ -0,0 +1,119 @@
+#include "lcf/lcf.h"
+#include "lcf/lcf.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Multi-threaded alloc/free mix: every thread keeps LIVE objects of random small sizes and
+   replaces a random one each op. Then each thread frees what its neighbour left, so the Slab
+   run includes remote frees. Arena_take has no free, it is the floor for the take side. */
+#define THREADS 4
+#define OPS 2000000
+#define LIVE 4096
+#define MAX_SIZE 512
+
+enum BenchMode {
+    BENCH_MALLOC,
+    BENCH_ARENA,
+    BENCH_SLAB,
+    BENCH_COUNT
+};
+char *bench_names[BENCH_COUNT] = { "malloc", "Arena_take", "SlabCache" };
+
+typedef struct Worker {
+    os_Thread thread;
+    u32 mode;
+    u32 phase;
+    RNG rng;
+    Arena *arena;
+    SlabCache cache;
+    void *live[LIVE];
+    struct Worker *neighbour;
+} Worker;
+
+static void* bench_take(Worker *w, u64 size) {
+    switch (w->mode) {
+        case BENCH_MALLOC: return malloc(size);
+        case BENCH_ARENA: return Arena_take(w->arena, size);
+        case BENCH_SLAB: return SlabCache_take(&w->cache, size);
+    }
+    return 0;
+}
+
+static void bench_free(Worker *w, void *p) {
+    switch (w->mode) {
+        case BENCH_MALLOC: free(p); break;
+        case BENCH_ARENA: break;
+        case BENCH_SLAB: SlabCache_free(&w->cache, p); break;
+    }
+}
+
+static OS_THREAD_PROC(bench_worker) {
+    Worker *w = (Worker*) data;
+    if (w->phase == 0) {
+        for (s32 i = 0; i < LIVE; i++) {
+            w->live[i] = bench_take(w, 1 + randu32(&w->rng) % MAX_SIZE);
+        }
+        for (s32 i = 0; i < OPS; i++) {
+            u32 r = randu32(&w->rng);
+            void **slot = w->live + (r % LIVE);
+            bench_free(w, *slot);
+            *slot = bench_take(w, 1 + (r >> 16) % MAX_SIZE);
+            *(u8*) *slot = (u8) i;
+        }
+    } else {
+        for (s32 i = 0; i < LIVE; i++) {
+            bench_free(w, w->neighbour->live[i]);
+        }
+    }
+}
+
+int main(void) {
+    os_PlatformInit();
+    Arena *a = Arena_create();
+    SlabHeap *slabs = SlabHeap_create(a);
+    Worker *workers = Arena_take_array_zero(a, Worker, THREADS);
+
+    for (u32 mode = 0; mode < BENCH_COUNT; mode++) {
+        for (s32 t = 0; t < THREADS; t++) {
+            Worker *w = workers + t;
+            w->mode = mode;
+            w->rng.s[0] = 0x9E3779B97F4A7C15ull * (t+1);
+            w->rng.s[1] = 0xD1B54A32D192ED03ull;
+            w->neighbour = workers + (t+1) % THREADS;
+            if (mode == BENCH_ARENA) {
+                w->arena = Arena_create(.flags = ARENA_COMMIT_GROW);
+            }
+            if (mode == BENCH_SLAB) {
+                SlabCache_begin(&w->cache, slabs);
+            }
+        }
+
+        u64 start = os_GetTimeMicroseconds();
+        for (u32 phase = 0; phase < 2; phase++) {
+            for (s32 t = 0; t < THREADS; t++) {
+                workers[t].phase = phase;
+                os_ThreadStart(&workers[t].thread, bench_worker, workers + t);
+            }
+            for (s32 t = 0; t < THREADS; t++) {
+                os_ThreadJoin(&workers[t].thread);
+            }
+        }
+        u64 elapsed = os_GetTimeMicroseconds() - start;
+
+        for (s32 t = 0; t < THREADS; t++) {
+            if (mode == BENCH_ARENA) {
+                Arena_destroy(workers[t].arena);
+            }
+            if (mode == BENCH_SLAB) {
+                SlabCache_end(&workers[t].cache);
+            }
+        }
+
+        u64 ops = (u64) THREADS * (OPS + 2*LIVE);
+        printf("%-12s %8.2f ms  %6.2f ns/op\n", bench_names[mode], elapsed/1000.0, elapsed*1000.0/ops);
+    }
+    printf("slabs carved: %llu (%llu KB)\n", (unsigned long long) slabs->slabs,
+           (unsigned long long) (slabs->slabs*LCF_MEMORY_SLAB_SIZE/1024));
+    return 0;
+}
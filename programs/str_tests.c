@@ -2,8 +2,607 @@
 #include "lcf/lcf.c"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* str_to_f64 against strtod, bit for bit */
+static u64 f64_bits(f64 f) {
+    u64 u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static unsigned long long compared, mismatches; /* Not u64, so %llu works everywhere */
+static void compare_strtod(char *s) {
+    s32 failure;
+    f64 got = str_to_f64(str_from_cstring(s), &failure);
+    f64 want = strtod(s, 0);
+    compared++;
+    if (failure || f64_bits(got) != f64_bits(want)) {
+        if (mismatches++ < 10) {
+            printf("MISMATCH %s -> %a | %a%s\n", s, got, want, failure? " (failure)" : "");
+        }
+    }
+}
+
+/* Exact decimal of m * 2^e as "<digits>e<exp10>", in base 1e9 limbs. m * 2^e is m * 5^-e * 10^e
+   when e < 0. */
+#define BIG_LIMBS 130
+static void exact_decimal(char *out, u64 m, s32 e) {
+    u32 limb[BIG_LIMBS];
+    s32 n = 0;
+    for (; m; m /= 1000000000) {
+        limb[n++] = (u32) (m % 1000000000);
+    }
+    s32 exp10 = (e < 0)? e : 0;
+    for (s32 k = (e < 0)? -e : e; k > 0; ) {
+        s32 step = MIN(k, (e < 0)? 13 : 29); /* 5^13 and 2^29 fit in 32 bits */
+        u64 mul = 1;
+        for (s32 j = 0; j < step; j++) {
+            mul *= (e < 0)? 5 : 2;
+        }
+        u64 carry = 0;
+        for (s32 j = 0; j < n; j++) {
+            u64 t = limb[j]*mul + carry;
+            limb[j] = (u32) (t % 1000000000);
+            carry = t / 1000000000;
+        }
+        while (carry) {
+            limb[n++] = (u32) (carry % 1000000000);
+            carry /= 1000000000;
+        }
+        k -= step;
+    }
+    out += sprintf(out, "%u", limb[n-1]);
+    for (s32 j = n-2; j >= 0; j--) {
+        out += sprintf(out, "%09u", limb[j]);
+    }
+    sprintf(out, "e%d", exp10);
+}
+
+/* The halfway point between d and the next double up, then just above and just below it */
+static void compare_halfway(f64 d) {
+    char s[1400];
+    u64 u = f64_bits(d);
+    s32 biased = (s32) (u >> 52);
+    u64 m = u & ((1ull << 52) - 1);
+    s32 e = (biased == 0)? -1074 : biased - 1075;
+    if (biased) {
+        m |= 1ull << 52;
+    }
+    exact_decimal(s, 2*m + 1, e - 1);
+    compare_strtod(s);
+
+    char *exp = strchr(s, 'e');
+    s32 exp10 = atoi(exp + 1);
+    char digits[1400];
+    s32 len = (s32) (exp - s);
+    memcpy(digits, s, len);
+
+    sprintf(digits + len, "1e%d", exp10 - 1); /* Above */
+    compare_strtod(digits);
+
+    digits[len] = 0;
+    for (s32 j = len-1; j >= 0; j--) { /* Below, digits - 1 followed by a 9 */
+        if (digits[j] != '0') {
+            digits[j]--;
+            break;
+        }
+        digits[j] = '9';
+    }
+    sprintf(digits + len, "9e%d", exp10 - 1);
+    compare_strtod(digits);
+}
+
+static void compare_f64(s32 count) {
+    RNG rng = {{ 0x9E3779B97F4A7C15ull, 0xD1B54A32D192ED03ull }};
+    char s[1400];
+    compared = mismatches = 0;
+
+    /* Random doubles at every precision */
+    for (s32 i = 0; i < count; i++) {
+        f64 d;
+        u64 u = randu64(&rng);
+        memcpy(&d, &u, sizeof(d));
+        if (IS_NAN(d) || d - d != 0) {
+            continue;
+        }
+        for (s32 precision = 0; precision <= 17; precision++) {
+            sprintf(s, "%.*e", precision, d);
+            compare_strtod(s);
+        }
+        sprintf(s, "%.17g", d);
+        compare_strtod(s);
+        sprintf(s, "%a", d);
+        compare_strtod(s);
+    }
+    printf("random doubles: %llu compared, %llu mismatches\n", compared, mismatches);
+
+    /* Random digit strings, up to 40 digits with a dot anywhere, across the whole exponent range */
+    compared = mismatches = 0;
+    for (s32 i = 0; i < count; i++) {
+        char *c = s;
+        if (randu32(&rng) & 1) *c++ = '-';
+        s32 digits = 1 + randu32(&rng) % 40;
+        s32 dot = randu32(&rng) % (digits + 1);
+        for (s32 j = 0; j < digits; j++) {
+            if (j == dot) *c++ = '.';
+            *c++ = (char) ('0' + randu32(&rng) % 10);
+        }
+        sprintf(c, "e%d", (s32) (randu32(&rng) % 700) - 350);
+        compare_strtod(s);
+    }
+    printf("random decimals: %llu compared, %llu mismatches\n", compared, mismatches);
+
+    /* Halfway cases, the hardest to round */
+    compared = mismatches = 0;
+    for (s32 i = 0; i < count/10; i++) {
+        f64 d;
+        u64 u = randu64(&rng) >> 1;
+        if ((u >> 52) >= 0x7FE) continue;
+        memcpy(&d, &u, sizeof(d));
+        compare_halfway(d);
+    }
+    f64 edges[] = { 0.0, 4.9406564584124654e-324, 2.2250738585072009e-308, 2.2250738585072014e-308,
+                    1.0, 9007199254740992.0, 1.7976931348623155e+308 };
+    for (s32 i = 0; i < ARRAY_LENGTH(edges); i++) {
+        compare_halfway(edges[i]);
+    }
+    printf("halfway cases: %llu compared, %llu mismatches\n", compared, mismatches);
+
+    /* Edges, overflow and underflow */
+    compared = mismatches = 0;
+    char *fixed[] = {
+        "1.7976931348623157e308", "1.7976931348623158e308", "1.797693134862315807e308", "1e309",
+        "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324",
+        "2.2250738585072011e-308", "1e-400", "0.000000000000000000000000000000000000001e-300",
+        "9007199254740993", "9007199254740993.0000000000000000000000000001", "123456789012345678901234567890",
+        "0.1", "0.2", "0.3", "3.14159265358979323846264338327950288", "1e23", "8.98846567431158e307",
+        "7.2057594037927933e+16", "1448997445238699", "0.000001", "1e-5", "5e-324", "1e22", "1e-22",
+    };
+    for (s32 i = 0; i < ARRAY_LENGTH(fixed); i++) {
+        compare_strtod(fixed[i]);
+    }
+    printf("edge cases: %llu compared, %llu mismatches\n", compared, mismatches);
+}
+
+/* Shortest formatting reads back exactly as the same f64 or f32 */
+static void compare_shortest(Arena *a, s32 count) {
+    RNG rng = {{ 0x2545F4914F6CDD1Dull, 0x9E3779B97F4A7C15ull }};
+    compared = mismatches = 0;
+    f64 fixed64[] = { 0.0, -0.0, 0.1, 1.0/3.0, 5e-324, 2.2250738585072009e-308, 2.2250738585072014e-308,
+                      1.7976931348623157e308, 1e23, 9007199254740993.0, 123456.0, 1e21, 1e-7, INFINITY, -INFINITY, NAN };
+    f32 fixed32[] = { 0.0f, -0.0f, 0.1f, 1.0f/3.0f, 1e-45f, 1.1754942e-38f, 1.17549435e-38f, 3.4028235e38f,
+                      16777217.0f, 1e10f, 1e-7f, INFINITY, -INFINITY, NAN };
+    for (s32 i = 0; i < count + ARRAY_LENGTH(fixed64) + ARRAY_LENGTH(fixed32); i++) {
+        ArenaSession session = ArenaSession_begin(a);
+        f64 d;
+        f32 f;
+        s32 is_f32;
+        if (i < count) {
+            u64 u = randu64(&rng);
+            u32 u32_bits = (u32) u;
+            is_f32 = (s32) (u >> 63);
+            memcpy(&d, &u, sizeof(d));
+            memcpy(&f, &u32_bits, sizeof(f));
+        } else if (i < count + ARRAY_LENGTH(fixed64)) {
+            is_f32 = 0;
+            d = fixed64[i - count];
+        } else {
+            is_f32 = 1;
+            f = fixed32[i - count - ARRAY_LENGTH(fixed64)];
+        }
+
+        str s = is_f32? str_from_f32(a, f) : str_from_f64(a, d);
+        s32 failure;
+        f64 back = str_to_f64(s, &failure);
+        s32 same;
+        if (is_f32) {
+            f32 back32 = (f32) back;
+            same = IS_NAN(f)? IS_NAN(back32) : memcmp(&back32, &f, sizeof(f)) == 0;
+        } else {
+            same = IS_NAN(d)? IS_NAN(back) : f64_bits(back) == f64_bits(d);
+        }
+        compared++;
+        if (failure || !same) {
+            if (mismatches++ < 10) {
+                printf("MISMATCH %a -> %.*s\n", is_f32? (f64) f : d, str_PRINTF_ARGS(s));
+            }
+        }
+        ArenaSession_end(session);
+    }
+    printf("shortest floats: %llu compared, %llu mismatches\n", compared, mismatches);
+}
+
+/* str_to_u64 against strtoull and str_count_digits against a byte loop, with digit runs of every
+   length around the 8 and 16 byte chunks and a non digit dropped in at every position */
+static s64 count_digits_slow(str s, s32 base) {
+    s64 i = 0;
+    for (; i < s.len; i++) {
+        char c = s.str[i];
+        s32 digit = (c >= '0' && c <= '9')? c - '0' : ((c|32) >= 'a' && (c|32) <= 'f')? (c|32) - 'a' + 10 : 99;
+        if (digit >= base) {
+            break;
+        }
+    }
+    return i;
+}
+
+static void compare_u64(char *s, s32 prefix, s64 len, s32 base) {
+    char c[64];
+    memcpy(c, s, prefix + len);
+    c[prefix + len] = 0;
+    s32 failure;
+    u64 got = str_to_u64(str_from(s, prefix + len), &failure);
+    char *end;
+    u64 want = strtoull(c + prefix, &end, base);
+    s32 want_failure = (end == c + prefix) && base != 8; /* The 0 of octal is a digit */
+    compared++;
+    if (failure != want_failure || got != want) {
+        if (mismatches++ < 10) {
+            printf("MISMATCH %s -> %llu | %llu%s\n", c, (unsigned long long) got, (unsigned long long) want, failure? " (failure)" : "");
+        }
+    }
+}
+
+static void compare_integers(void) {
+    RNG rng = {{ 0xD1B54A32D192ED03ull, 0x2545F4914F6CDD1Dull }};
+    char *prefixes[] = { "", "0x", "0b", "0" };
+    s32 bases[] = { 10, 16, 2, 8 };
+    s32 caps[] = { 19, 16, 64, 21 };
+    char *hex = "0123456789abcdefABCDEF";
+    compared = mismatches = 0;
+    for (s32 p = 0; p < ARRAY_LENGTH(prefixes); p++) {
+        s32 prefix = (s32) strlen(prefixes[p]);
+        for (s32 len = 1; len <= 40; len++) {
+            for (s32 bad = -1; bad < len; bad++) {
+                char s[64];
+                memcpy(s, prefixes[p], prefix);
+                char *digits = s + prefix;
+                s32 base = bases[p];
+                for (s32 j = 0; j < len; j++) {
+                    digits[j] = hex[randu32(&rng) % ((base == 16)? 22 : base)];
+                }
+                if (prefix == 0) {
+                    digits[0] = (char) ('1' + randu32(&rng) % 9); /* Or it would be octal */
+                }
+                if (bad >= 0) {
+                    digits[bad] = "zG/:@`g.h"[randu32(&rng) % 9];
+                }
+
+                /* strtoull saturates where str_to_u64 ignores digits past the cap */
+                s64 run = count_digits_slow(str_from(digits, len), base);
+                if (run <= caps[p]) {
+                    compare_u64(s, prefix, len, base);
+                }
+
+                for (s32 b = 0; b < 4; b++) {
+                    s32 count_base = (s32[]){ 2, 8, 10, 16 }[b];
+                    str t = str_from(digits, len);
+                    compared++;
+                    if (str_count_digits(t, count_base) != count_digits_slow(t, count_base)) {
+                        if (mismatches++ < 10) {
+                            printf("MISMATCH str_count_digits %.*s base %d\n", str_PRINTF_ARGS(t), count_base);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* Digits past the cap are ignored rather than overflowing */
+    struct { char *s; u64 n; s32 failure; } fixed[] = {
+        { "0", 0, 0 }, { "7", 7, 0 }, { "00", 0, 0 }, { "08", 0, 0 }, { "0x", 0, 1 }, { "0b", 0, 1 }, { "", 0, 1 }, { "z", 0, 1 },
+        { "18446744073709551615", 1844674407370955161ull, 0 }, { "9999999999999999999", 9999999999999999999ull, 0 },
+        { "0xFFFFFFFFFFFFFFFF", 0xFFFFFFFFFFFFFFFFull, 0 }, { "0x123456789ABCDEF01", 0x123456789ABCDEF0ull, 0 },
+        { "0x1A2B3C4D", 0x1A2B3C4D, 0 }, { "0x1a2b3c4d,", 0x1A2B3C4D, 0 }, { "0x@", 0, 1 }, { "0x1@", 1, 0 },
+        { "0777777777777777777777", 0777777777777777777777ull, 0 }, { "07777777777777777777777", 0777777777777777777777ull, 0 },
+        { "12345678z9", 12345678, 0 },
+    };
+    for (s32 i = 0; i < ARRAY_LENGTH(fixed); i++) {
+        s32 failure;
+        u64 got = str_to_u64(str_from_cstring(fixed[i].s), &failure);
+        compared++;
+        if (got != fixed[i].n || failure != fixed[i].failure) {
+            if (mismatches++ < 10) {
+                printf("MISMATCH %s -> %llu | %llu%s\n", fixed[i].s, (unsigned long long) got, (unsigned long long) fixed[i].n, failure? " (failure)" : "");
+            }
+        }
+    }
+    printf("integers: %llu compared, %llu mismatches\n", compared, mismatches);
+}
+
+/* str_substring_location against a byte by byte search. Two letter alphabets make lots of
+   overlapping partial matches, needles go past LCF_STRING_SHORT_NEEDLE into Two-Way. */
+static s64 substring_location_slow(str s, str sub) {
+    for (s64 i = 0; i + sub.len <= s.len; i++) {
+        if (memcmp(s.str + i, sub.str, sub.len) == 0) {
+            return i;
+        }
+    }
+    return LCF_STRING_NO_MATCH;
+}
+
+static void compare_substrings(s32 count) {
+    RNG rng = {{ 0x9E3779B97F4A7C15ull, 0x2545F4914F6CDD1Dull }};
+    compared = mismatches = 0;
+
+    /* Regression: a mismatch used to restart the match without rechecking the current byte */
+    char *fixed[][2] = { { "aaab", "aab" }, { "abababc", "ababc" }, { "xxaaxaaab", "aaab" }, { "ab", "abc" }, { "", "a" } };
+    for (s32 i = 0; i < ARRAY_LENGTH(fixed); i++) {
+        str s = str_from_cstring(fixed[i][0]), sub = str_from_cstring(fixed[i][1]);
+        compared++;
+        if (str_substring_location(s, sub) != substring_location_slow(s, sub)) {
+            mismatches++;
+            printf("MISMATCH %s in %s\n", fixed[i][1], fixed[i][0]);
+        }
+    }
+
+    char hay[512], needle[128];
+    for (s32 i = 0; i < count; i++) {
+        s32 n = randu32(&rng) % 400;
+        s32 m = 1 + randu32(&rng) % 80;
+        char *letters = (randu32(&rng) & 1)? "ab" : "abcd";
+        s32 k = (s32) strlen(letters);
+        s32 offset = randu32(&rng) % 32;
+        for (s32 j = 0; j < n; j++) {
+            hay[offset + j] = letters[randu32(&rng) % k];
+        }
+        if (n >= m && (randu32(&rng) & 1)) {
+            memcpy(needle, hay + offset + randu32(&rng) % (n - m + 1), m);
+            needle[randu32(&rng) % m] ^= (randu32(&rng) & 1)? 3 : 0; /* Sometimes one letter off */
+        } else {
+            for (s32 j = 0; j < m; j++) {
+                needle[j] = letters[randu32(&rng) % k];
+            }
+        }
+        str s = str_from(hay + offset, n), sub = str_from(needle, m);
+        compared++;
+        s64 got = str_substring_location(s, sub), want = substring_location_slow(s, sub);
+        if (got != want) {
+            if (mismatches++ < 10) {
+                printf("MISMATCH %.*s in %.*s -> %lld | %lld\n", str_PRINTF_ARGS(sub), str_PRINTF_ARGS(s), (long long) got, (long long) want);
+            }
+        }
+    }
+    printf("substrings: %llu compared, %llu mismatches\n", compared, mismatches);
+}
+
+/* str_charset_location and str_delimiter_location against StrCharset_has in a byte loop. Every
+   byte value is in some set, at every start offset within a vector and lengths past the two
+   vector loop into the tail, with set members just outside s on both sides. */
+#define SEARCH_VEC 32 /* The widest STR_VEC */
+static s64 charset_location_slow(str s, StrCharset *set) {
+    for (s64 i = 0; i < s.len; i++) {
+        if (StrCharset_has(set, s.str[i])) {
+            return i;
+        }
+    }
+    return LCF_STRING_NO_MATCH;
+}
+
+static void compare_charsets(void) {
+    RNG rng = {{ 0x6A09E667F3BCC909ull, 0xBB67AE8584CAA73Bull }};
+    compared = mismatches = 0;
+    static char storage[8*SEARCH_VEC], filler[8*SEARCH_VEC];
+    char *buf = (char*) (((upr) storage + SEARCH_VEC-1) & ~(upr) (SEARCH_VEC-1));
+    for (s32 b = 0; b < 256; b++) {
+        char members[4];
+        members[0] = (char) b;
+        s32 member_count = 1 + randu32(&rng) % ARRAY_LENGTH(members);
+        for (s32 j = 1; j < member_count; j++) {
+            members[j] = (char) randu32(&rng);
+        }
+        str delims = str_from(members, member_count);
+        StrCharset set = StrCharset_from(delims);
+        for (s32 j = 0; j < ARRAY_LENGTH(filler); j++) {
+            do {
+                filler[j] = (char) randu32(&rng);
+            } while (StrCharset_has(&set, filler[j]));
+        }
+        for (s32 start = 1; start <= SEARCH_VEC; start++) {
+            for (s64 len = 0; len <= 5*SEARCH_VEC + 1; len++) {
+                memcpy(buf, filler, 6*SEARCH_VEC + 2);
+                str s = str_from(buf + start, len);
+                s.str[-1] = members[randu32(&rng) % member_count];
+                s.str[len] = members[randu32(&rng) % member_count];
+                s64 at = randu32(&rng) % (len + SEARCH_VEC); /* Often no match at all */
+                if (at < len) {
+                    s.str[at] = members[randu32(&rng) % member_count];
+                }
+                s64 want = charset_location_slow(s, &set);
+                s64 got = str_charset_location(s, &set);
+                s64 got_delims = str_delimiter_location(s, delims);
+                compared++;
+                if (got != want || got_delims != want) {
+                    if (mismatches++ < 10) {
+                        printf("MISMATCH byte 0x%02x start %d len %lld -> %lld, delims %lld | %lld\n",
+                               b, start, (long long) len, (long long) got, (long long) got_delims, (long long) want);
+                    }
+                }
+            }
+        }
+    }
+    printf("charsets: %llu compared, %llu mismatches\n", compared, mismatches);
+}
+
+/* str_char_location and str_char_location_backward against a byte loop, at every start offset
+   within a vector, every length up to two vectors and one, and every match position paired with
+   a second one mirrored from the end, with the same char just outside s on both sides. */
+static void compare_char_locations(void) {
+    compared = mismatches = 0;
+    static char storage[4*SEARCH_VEC];
+    char *buf = (char*) (((upr) storage + SEARCH_VEC-1) & ~(upr) (SEARCH_VEC-1));
+    for (s32 start = 1; start <= SEARCH_VEC; start++) {
+        for (s64 len = 0; len <= 2*SEARCH_VEC + 1; len++) {
+            for (s64 at = -1; at <= len; at++) {
+                char c = (char) (start*131 + len*7 + at); /* Bytes past 0x7f too */
+                memset(buf, c ^ 0x5a, 2*SEARCH_VEC + 2 + start);
+                str s = str_from(buf + start, len);
+                s64 mirror = len - 1 - at;
+                s.str[-1] = s.str[len] = s.str[at] = s.str[mirror] = c;
+                s64 want = (at >= 0 && at < len)? MIN(at, mirror) : LCF_STRING_NO_MATCH;
+                s64 want_backward = (at >= 0 && at < len)? MAX(at, mirror) : LCF_STRING_NO_MATCH;
+                s64 got = str_char_location(s, c);
+                s64 got_backward = str_char_location_backward(s, c);
+                compared++;
+                if (got != want || got_backward != want_backward) {
+                    if (mismatches++ < 10) {
+                        printf("MISMATCH start %d len %lld at %lld -> %lld, backward %lld\n",
+                               start, (long long) len, (long long) at, (long long) got, (long long) got_backward);
+                    }
+                }
+            }
+        }
+    }
+    printf("char locations: %llu compared, %llu mismatches\n", compared, mismatches);
+}
+
+/* StrMatcher against checking every pattern at every end position, in the order StrMatchIter
+   gives them: by end, then longest first, then by pattern index. Small alphabets give lots of
+   overlaps, and the input is fed in random chunks so matches span the chunk boundaries. */
+#define MATCHES_MAX 4096
+static s32 matches_slow(str s, str *patterns, u32 count, StrMatch *out) {
+    s64 longest = 0;
+    for (u32 p = 0; p < count; p++) {
+        longest = MAX(longest, patterns[p].len);
+    }
+    s32 n = 0;
+    for (s64 end = 1; end <= s.len; end++) {
+        for (s64 len = MIN(end, longest); len > 0; len--) {
+            for (u32 p = 0; p < count; p++) {
+                if (patterns[p].len == len && memcmp(s.str + end - len, patterns[p].str, len) == 0) {
+                    out[n++] = (StrMatch) { p, end - len, len };
+                }
+            }
+        }
+    }
+    return n;
+}
+
+static s32 matches_fast(StrMatcher *m, str s, s64 *cuts, s32 cut_count, StrMatch *out) {
+    s32 n = 0;
+    StrMatchIter it = StrMatcher_begin(m, str_from(s.str, cuts[0]));
+    for (s32 c = 0; ; c++) {
+        while (n < MATCHES_MAX && StrMatchIter_next(&it, &out[n])) {
+            n++;
+        }
+        if (c + 1 >= cut_count) {
+            break;
+        }
+        StrMatchIter_feed(&it, str_from(s.str + cuts[c], cuts[c+1] - cuts[c]));
+    }
+    return n;
+}
+
+static void compare_match_lists(str s, StrMatcher *m, str *patterns, u32 count, s64 *cuts, s32 cut_count) {
+    static StrMatch got[MATCHES_MAX], want[MATCHES_MAX];
+    s32 n = matches_fast(m, s, cuts, cut_count, got);
+    s32 k = matches_slow(s, patterns, count, want);
+    compared++;
+    s32 same = (n == k);
+    for (s32 i = 0; same && i < n; i++) {
+        same = got[i].pattern == want[i].pattern && got[i].offset == want[i].offset && got[i].len == want[i].len;
+    }
+    if (!same && mismatches++ < 10) {
+        printf("MISMATCH %u patterns in %.*s -> %d | %d matches\n", count, str_PRINTF_ARGS(s), n, k);
+    }
+}
+
+static void compare_matcher(Arena *a, s32 count) {
+    RNG rng = {{ 0xD1B54A32D192ED03ull, 0x9E3779B97F4A7C15ull }};
+    compared = mismatches = 0;
+
+    /* Overlaps, a duplicate, a suffix of another pattern and an empty pattern */
+    str fixed[] = { strl("he"), strl("she"), strl("his"), strl("hers"), strl("he"), strl("s"), strl(""), strl("aa"), strl("aaa") };
+    char *inputs[] = { "ushers", "hishershe", "aaaaaa", "", "xyz" };
+    StrMatcher *m = StrMatcher_create(a, fixed, ARRAY_LENGTH(fixed));
+    for (s32 i = 0; i < ARRAY_LENGTH(inputs); i++) {
+        str s = str_from_cstring(inputs[i]);
+        for (s64 cut = 0; cut <= s.len; cut++) {
+            s64 cuts[] = { cut, s.len };
+            compare_match_lists(s, m, fixed, ARRAY_LENGTH(fixed), cuts, 2);
+        }
+    }
+
+    /* Every byte value in the patterns, so no byte is left for the class of unused bytes */
+    char all[256], text[512];
+    for (s32 i = 0; i < 256; i++) {
+        all[i] = (char) i;
+        text[i] = text[256 + i] = (char) (255 - i);
+    }
+    str bytes[] = { str_from(all, 256), str_from(all + 10, 3), str_from(all + 254, 2), str_from(all, 1) };
+    m = StrMatcher_create(a, bytes, ARRAY_LENGTH(bytes));
+    s64 whole[] = { 512 };
+    compare_match_lists(str_from(text, 512), m, bytes, ARRAY_LENGTH(bytes), whole, 1);
+    for (s32 i = 0; i < 256; i++) {
+        text[i] = (char) i;
+    }
+    compare_match_lists(str_from(text, 512), m, bytes, ARRAY_LENGTH(bytes), whole, 1);
+
+    str patterns[8];
+    char pattern_bytes[8][8], hay[300];
+    for (s32 i = 0; i < count; i++) {
+        ArenaSession session = ArenaSession_begin(a);
+        char *letters = (randu32(&rng) & 1)? "ab" : "ab\x80\xff";
+        s32 k = (s32) strlen(letters);
+        u32 n = 1 + randu32(&rng) % 8;
+        for (u32 p = 0; p < n; p++) {
+            if (p > 0 && randu32(&rng) % 8 == 0) {
+                patterns[p] = patterns[randu32(&rng) % p]; /* Duplicate */
+                continue;
+            }
+            s32 len = randu32(&rng) % 7;
+            for (s32 j = 0; j < len; j++) {
+                pattern_bytes[p][j] = letters[randu32(&rng) % k];
+            }
+            patterns[p] = str_from(pattern_bytes[p], len);
+        }
+        s64 len = randu32(&rng) % ARRAY_LENGTH(hay);
+        for (s64 j = 0; j < len; j++) {
+            hay[j] = letters[randu32(&rng) % k];
+        }
+        s64 cuts[6];
+        s32 cut_count = 1 + randu32(&rng) % ARRAY_LENGTH(cuts);
+        for (s32 c = 0; c < cut_count - 1; c++) {
+            cuts[c] = len? randu32(&rng) % (len + 1) : 0;
+        }
+        cuts[cut_count - 1] = len;
+        for (s32 c = 1; c < cut_count; c++) { /* Sort, empty chunks are fine */
+            for (s32 d = c; d > 0 && cuts[d-1] > cuts[d]; d--) {
+                SWAP(s64, cuts[d-1], cuts[d]);
+            }
+        }
+        m = StrMatcher_create(a, patterns, n);
+        compare_match_lists(str_from(hay, len), m, patterns, n, cuts, cut_count);
+        ArenaSession_end(session);
+    }
+
+    /* A table past u32 indices fails and gives back what it took from the arena */
+    u32 too_many = 1 << 16;
+    str *big = Arena_take_array(a, str, too_many);
+    for (u32 i = 0; i < too_many; i++) {
+        big[i] = str_from(all, 256);
+    }
+    u64 pos = Arena_pos(a);
+    compared++;
+    if (StrMatcher_create(a, big, too_many) != 0 || Arena_pos(a) != pos) {
+        mismatches++;
+        printf("MISMATCH StrMatcher_create of %u patterns\n", too_many);
+    }
+    printf("matcher: %llu compared, %llu mismatches\n", compared, mismatches);
+}
+
+int main(int argc, char **argv) {
+    compare_f64((argc > 1)? atoi(argv[1]) : 100000);
+    Arena *a = Arena_create();
+    compare_shortest(a, (argc > 1)? atoi(argv[1]) : 100000);
+    compare_integers();
+    compare_substrings((argc > 1)? atoi(argv[1]) : 100000);
+    compare_char_locations();
+    compare_charsets();
+    compare_matcher(a, (argc > 1)? atoi(argv[1]) : 100000);
 
-int main() {
     // str_to_f64 tests
     s32 f; str s;
     s = strl("0.01"); printf("%.*s -> %g | %g\n", (s32)s.len, s.str, str_to_f64(s, &f), atof(s.str));